@@ -0,0 +1,56 @@
+#ifndef ADC_FILTER_H
+#define ADC_FILTER_H
+
+#include <Arduino.h>
+
+// Ring of the last N raw ADC samples. value() sorts a copy and averages the
+// middle half, which drops spikes like a median does but keeps the sub-LSB
+// resolution of an average.
+template <uint8_t N>
+class AdcFilter {
+  static_assert(N > 0 && N <= 32, "AdcFilter sorts on the stack; keep N small");
+
+public:
+  void push(uint16_t raw) {
+    samples[next] = raw;
+    next = (next + 1) % N;
+    if (count < N) {
+      count++;
+    }
+  }
+
+  bool empty() const {
+    return count == 0;
+  }
+
+  float value() const {
+    if (count == 0) {
+      return 0.0;
+    }
+
+    uint16_t sorted[N];
+    for (uint8_t i = 0; i < count; i++) {
+      uint16_t v = samples[i];
+      uint8_t j = i;
+      while (j > 0 && sorted[j - 1] > v) {
+        sorted[j] = sorted[j - 1];
+        j--;
+      }
+      sorted[j] = v;
+    }
+
+    uint8_t trim = count / 4;
+    uint32_t sum = 0;
+    for (uint8_t i = trim; i < count - trim; i++) {
+      sum += sorted[i];
+    }
+    return (float)sum / (count - 2 * trim);
+  }
+
+private:
+  uint16_t samples[N];
+  uint8_t next = 0;
+  uint8_t count = 0;
+};
+
+#endif
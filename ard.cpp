@@ -1,252 +1,274 @@
-#include "Adafruit_SHT31.h"
 #include <Wire.h>
 #include <math.h>
 #include <AccelStepper.h>
+#include "job_scheduler.h"
+#include "sensor_snapshot.h"
+#include "sensor_sampler.h"
+#include "bridge_protocol.h"
+#include "control_core.h"
 
-// Pin Definitions
-#define DHT_PIN 3
-#define PH_PIN A2
-#define VPD_PUMP_RELAY 9
-#define ACID_PUMP_RELAY 8
-#define BASE_PUMP_RELAY 7
-#define MIX_PUMP_RELAY 2
-#define TRIG_PIN 5
-#define ECHO_PIN 4
-#define LDR_PIN A1
-#define STEPPER_STEP_PIN 12
-#define STEPPER_DIR_PIN 13
+// Board profile for the Uno (see control_core.h and sensor_sampler.h)
+struct Board {
+  static constexpr uint8_t phPin = A2;
+  static constexpr uint8_t ldrPin = A1;
+  static constexpr uint8_t vpdRelay = 9;
+  static constexpr uint8_t acidRelay = 8;
+  static constexpr uint8_t baseRelay = 7;
+  static constexpr uint8_t mixRelay = 2;
+  static constexpr uint8_t trigPin = 5;
+  static constexpr uint8_t echoPin = 3;  // Must be INT0/INT1 (pin 2 or 3) for the echo interrupt
+  static constexpr uint8_t stepPin = 12;
+  static constexpr uint8_t dirPin = 13;
+  static constexpr uint8_t sdaPin = A4;
+  static constexpr uint8_t sclPin = A5;
+  static constexpr uint8_t sht31Address = 0x44;  // 0x45 with ADDR pulled high
+  static constexpr uint8_t i2cMuxChannel = NO_MUX;
+  static constexpr uint16_t adcMax = 1023;
+  static constexpr float pHAtZero = 0.0;
+  static constexpr float pHAtFullScale = 14.0;
+  static constexpr bool digitalLight = false;
+  static constexpr int defaultLightThreshold = 300;
+  static constexpr float reservoirRadius = 20.0;
+  static constexpr float reservoirHeight = 35.0;
+};
 
 // Constants
-#define DHTTYPE DHT11
-#define VPD_PUMP_DURATION 5000
-#define MIX_PUMP_DURATION 1000
-#define PH_CHECK_INTERVAL 30000
-#define PH_WAIT_INTERVAL 18000
-#define PH_LOWER_LIMIT 5.5
-#define PH_UPPER_LIMIT 6.5
-#define DOSAGE_RATE 0.00025 // 1 ml per 4 liters
-#define RESERVOIR_RADIUS 20.0
-#define RESERVOIR_HEIGHT 35.0
-#define RESERVOIR_CHECK_INTERVAL 3600
-#define ROTATION_INTERVAL 5000
-#define STEPS_PER_REVOLUTION 200
-#define STEPS_90_DEGREES (STEPS_PER_REVOLUTION / 4)
+// 1 dumps the job table every SCHEDULE_REPORT_INTERVAL. Off by default: the
+// ~470 bytes hold loop() for half a second at 9600 baud and land in the
+// middle of the bridge's frames.
+#define SCHEDULE_REPORT 0
+#define SCHEDULE_REPORT_INTERVAL 60000
+#define SCHEDULE_REPORT_RETRY 1000  // While a rotation is running
+#define TELEMETRY_INTERVAL 1000
+// The web bridge listens on the hardware UART; the debug prints share it and
+// are skipped by the bridge's frame parser
+#define BRIDGE_SERIAL Serial
+#define BRIDGE_POLL_INTERVAL 10     // ms; the 64-byte UART buffer holds ~65 ms at 9600 baud
+#define MANUAL_PULSE_MAX 10000      // Longest manual pump pulse accepted from the bridge
 
 // Global variables
-Adafruit_SHT31 sht31 = Adafruit_SHT31();
-AccelStepper stepper(AccelStepper::DRIVER, STEPPER_STEP_PIN, STEPPER_DIR_PIN);
-
-unsigned long lastVPDCycleTime = 0;
-unsigned long vpdCycleInterval = 1200; // 2 minutes default
-unsigned long lastpHCheckTime = 0;
-unsigned long lastReservoirCheckTime = 0;
-unsigned long lastRotationTime = 0;
-
-bool isVPDPumping = false;
-bool isPHAdjusting = false;
-bool isPHWaiting = false;
-
-long ph_pump_duration = 0;
-
-float temperature = 0.0;
-float humidity = 0.0;
-float vpd = 0.0;
-float pH = 0.0;
-float waterLevel = 0.0;
-float reservoirVolume = 0.0;
-int lightIntensity = 0;
-int LIGHT_THRESHOLD = 300;
-float PH_TARGET = 6.0;
+AccelStepper stepper(AccelStepper::DRIVER, Board::stepPin, Board::dirPin);
+static_assert(digitalPinToInterrupt(Board::echoPin) != NOT_AN_INTERRUPT, "echoPin needs an external interrupt");
+JobScheduler scheduler;
+
+// Sensor values are only read by sampleSensors(); everything else uses the snapshot
+SensorSnapshot snapshot;
+SensorSampler<Board> sampler(snapshot);
+
+ControlCore<Board> control(snapshot, stepper);
+
+// Commands from the web bridge, parsed a byte at a time as they arrive
+FrameAssembler bridgeFrames;
+
+// Manual pump pulses requested over the bridge, indexed by BridgePump
+const uint8_t pumpRelays[] = {Board::vpdRelay, Board::acidRelay, Board::baseRelay, Board::mixRelay};
+bool pulseActive[4] = {false, false, false, false};
+uint32_t pulseStartTime[4];
+uint16_t pulseDuration[4];
+
+// Function declarations
+uint32_t sampleSensors(uint32_t currentTime);
+uint32_t reportSchedule(uint32_t currentTime);
+uint32_t sendTelemetry(uint32_t currentTime);
+uint32_t serviceBridge(uint32_t currentTime);
+void applyCommand(const BridgeCommand& command, uint32_t currentTime);
+BridgeAckStatus startPumpPulse(BridgePump pump, uint16_t durationMs, uint32_t currentTime);
+bool pumpInUse(BridgePump pump);
+bool& manualPulseFlag(BridgePump pump);
 
 void setup() {
   Serial.begin(9600);
   
-  pinMode(VPD_PUMP_RELAY, OUTPUT);
-  pinMode(ACID_PUMP_RELAY, OUTPUT);
-  pinMode(BASE_PUMP_RELAY, OUTPUT);
-  pinMode(MIX_PUMP_RELAY, OUTPUT);
-  pinMode(TRIG_PIN, OUTPUT);
-  pinMode(ECHO_PIN, INPUT);
-  
-  digitalWrite(VPD_PUMP_RELAY, HIGH);
-  digitalWrite(ACID_PUMP_RELAY, HIGH);
-  digitalWrite(BASE_PUMP_RELAY, HIGH);
-  digitalWrite(MIX_PUMP_RELAY, HIGH);
-  
-   if (! sht31.begin(0x44)) {   // Set to 0x45 for alternate I2C address
-    Serial.println("Couldn't find SHT31");
+  control.begin();
+  if (!sampler.begin()) {
+    Serial.println(F("Couldn't find SHT31"));
     while (1) delay(1);
   }
   stepper.setMaxSpeed(1000);
   stepper.setAcceleration(500);
-}
 
-void loop() {
-  unsigned long currentTime = millis();
-
-  // Read sensor data
-  temperature = sht31.readTemperature();
-  humidity = sht31.readHumidity();
-  vpd = calculateVPD(temperature, humidity);
-  pH = readpH();
-  waterLevel = measureWaterLevel();
-  reservoirVolume = calculateReservoirVolume(waterLevel);
-  lightIntensity = analogRead(LDR_PIN);
-
-  handleVPDControl(currentTime);
-  handlePHControl(currentTime);
-  checkReservoirVolume(currentTime);
-  checkLightAndRotate(currentTime);
-  
-  stepper.run();
+  // Every periodic job lives here; each one returns the ms until it is next due
+  scheduler.add("sensors", sampleSensors);
+  scheduler.add("vpd", [](uint32_t t) { return control.runVPD(t); });
+  scheduler.add("ph", [](uint32_t t) { return control.runPH(t); });
+  scheduler.add("reservoir", [](uint32_t t) { return control.runReservoir(t); });
+  scheduler.add("rotation", [](uint32_t t) { return control.runRotation(t); });
+  scheduler.add("telemetry", sendTelemetry, TELEMETRY_INTERVAL);
+  scheduler.add("bridge", serviceBridge);
+#if SCHEDULE_REPORT
+  scheduler.add("report", reportSchedule, SCHEDULE_REPORT_INTERVAL);
+#endif
 }
 
-void handleVPDControl(unsigned long currentTime) {
-  if (currentTime - lastVPDCycleTime >= vpdCycleInterval) {
-    lastVPDCycleTime = currentTime;
-    
-    float humidity = sht31.readHumidity();
-    float temperature = sht31.readTemperature();
-
-    if (!isnan(humidity) && !isnan(temperature)) {
-      float vpd = calculateVPD(temperature, humidity);
-      updateVPDCycleInterval(vpd);
-      
-      Serial.print("Humidity: ");
-      Serial.print(humidity, 1);
-      Serial.print("%, Temperature: ");
-      Serial.print(temperature, 1);
-      Serial.print("°C, VPD: ");
-      Serial.print(vpd, 2);
-      Serial.println(" kPa");
-    } else {
-      Serial.println("Failed to read from DHT sensor!");
-    }
+void loop() {
+  control.serviceRotation();
+  uint32_t idleMs = scheduler.runDue();
 
-    digitalWrite(VPD_PUMP_RELAY, LOW);
-    isVPDPumping = true;
-    Serial.println("VPD Pump activated");
+  // The stepper needs run() every step interval, so only sleep when it is idle
+  if (!control.isRotating) {
+    scheduler.idle(idleMs);
   }
+}
 
-  if (isVPDPumping && currentTime - lastVPDCycleTime >= VPD_PUMP_DURATION) {
-    digitalWrite(VPD_PUMP_RELAY, HIGH);
-    isVPDPumping = false;
-    Serial.println("VPD Pump deactivated");
-  }
+// Read each sensor at its own rate into the snapshot. The SHT31 read would
+// starve the stepper mid-move, so it waits out a rotation.
+uint32_t sampleSensors(uint32_t currentTime) {
+  bool climateRead;
+  sampler.sample(currentTime, !control.isRotating, climateRead);
+  uint32_t next = sampler.msUntilDue(currentTime);
+  // Anything still due was held back by a rotation; look again shortly
+  return next > 0 ? next : 100;
 }
 
-void handlePHControl(unsigned long currentTime) {
-  if (!isPHAdjusting && !isPHWaiting && currentTime - lastpHCheckTime >= PH_CHECK_INTERVAL) {
-    checkAndAdjustPH(currentTime);
+uint32_t reportSchedule(uint32_t currentTime) {
+  // A blocked write would hold up the stepper
+  if (control.isRotating) {
+    return SCHEDULE_REPORT_RETRY;
   }
+  scheduler.print(Serial);
+  return SCHEDULE_REPORT_INTERVAL;
+}
 
-  if (isPHWaiting && currentTime - lastpHCheckTime >= PH_WAIT_INTERVAL) {
-    isPHWaiting = false;
-    checkAndAdjustPH(currentTime);
-  }
+// Send the snapshot to the web bridge as one telemetry frame
+uint32_t sendTelemetry(uint32_t currentTime) {
+  SensorData data;
+  data.sequence = snapshot.sequence;
+  data.temperature = snapshot.temperature;
+  data.humidity = snapshot.humidity;
+  data.vpd = snapshot.vpd;
+  data.pH = snapshot.pH;
+  data.waterLevel = snapshot.waterLevel;
+  data.reservoirVolume = snapshot.reservoirVolume;
+  data.lightIntensity = snapshot.lightIntensity;
+  data.flags = (snapshot.climateValid ? SENSOR_CLIMATE_VALID : 0) |
+               (control.isVPDPumping ? SENSOR_MISTING : 0) |
+               (control.isRotating ? SENSOR_ROTATING : 0) |
+               (control.isPHAdjusting ? SENSOR_PH_ADJUSTING : 0) |
+               (control.pHFault ? SENSOR_PH_FAULT : 0);
 
-  if (isPHAdjusting && currentTime - lastpHCheckTime >= ph_pump_duration) {
-    digitalWrite(ACID_PUMP_RELAY, HIGH);
-    digitalWrite(BASE_PUMP_RELAY, HIGH);
-    digitalWrite(MIX_PUMP_RELAY, LOW);
-    
-    delay(MIX_PUMP_DURATION);
-    
-    digitalWrite(MIX_PUMP_RELAY, HIGH);
-    isPHAdjusting = false;
-    isPHWaiting = true;
-    Serial.println("pH adjustment cycle completed, waiting before rechecking");
-  }
+  uint8_t frame[BRIDGE_MAX_FRAME];
+  size_t length = encodeTelemetry(data, frame);
+  BRIDGE_SERIAL.write(frame, length);
+  return TELEMETRY_INTERVAL;
 }
 
-void checkReservoirVolume(unsigned long currentTime) {
-  if (currentTime - lastReservoirCheckTime >= RESERVOIR_CHECK_INTERVAL) {
-    lastReservoirCheckTime = currentTime;
-    
-    float waterLevel = measureWaterLevel();
-    float volume = calculateReservoirVolume(waterLevel);
-    
-    Serial.print("Volume: ");
-    Serial.print(volume, 1);
-    Serial.println(" liters");
-
-    ph_pump_duration = volume * DOSAGE_RATE * 1000000; // Convert to ms
+// Apply whatever commands have arrived from the bridge and end finished
+// manual pulses. Only reads the bytes already in the UART buffer.
+uint32_t serviceBridge(uint32_t currentTime) {
+  int received = BRIDGE_SERIAL.available();
+  while (received-- > 0) {
+    if (bridgeFrames.push(BRIDGE_SERIAL.read())) {
+      BridgeCommand command;
+      bool valid = decodeCommand(bridgeFrames.type(), bridgeFrames.payload(), bridgeFrames.payloadLength(), command);
+      if (valid) {
+        applyCommand(command, currentTime);
+      } else if (bridgeFrames.payloadLength() > 0) {
+        uint8_t frame[BRIDGE_MAX_FRAME];
+        BRIDGE_SERIAL.write(frame, encodeAck(command.sequence, bridgeFrames.type(), ACK_REJECTED, frame));
+      }
+    }
   }
-}
 
-void checkLightAndRotate(unsigned long currentTime) {
-  if (currentTime - lastRotationTime >= ROTATION_INTERVAL) {
-    lastRotationTime = currentTime;
-    
-    int lightIntensity = analogRead(LDR_PIN);
-    Serial.print("Light intensity = ");
-    Serial.println(lightIntensity);
-
-    if (lightIntensity > LIGHT_THRESHOLD) {
-      stepper.moveTo(stepper.currentPosition() + STEPS_90_DEGREES);
-      while (stepper.distanceToGo() != 0) {
-        stepper.run();
+  uint32_t next = BRIDGE_POLL_INTERVAL;
+  for (uint8_t p = 0; p < 4; p++) {
+    if (!pulseActive[p]) {
+      continue;
+    }
+    if (currentTime - pulseStartTime[p] >= pulseDuration[p]) {
+      pulseActive[p] = false;
+      manualPulseFlag((BridgePump)p) = false;
+      // The automatic control may have claimed the relay meanwhile; leave it on then
+      if (!pumpInUse((BridgePump)p)) {
+        digitalWrite(pumpRelays[p], RELAY_OFF);
       }
-      Serial.println("Rotated 90 degrees");
     } else {
-      Serial.println("Light intensity below threshold, not rotating");
+      next = min(next, timeUntil(currentTime, pulseStartTime[p], pulseDuration[p]));
     }
   }
+  return next;
 }
 
-float readpH() {
-  int sensorValue = analogRead(PH_PIN);
-  return map(sensorValue, 0, 1023, 0, 14);
-}
-
-float calculateVPD(float temperature, float humidity) {
-  float svp = 0.6108 * exp(17.27 * temperature / (temperature + 237.3)); 
-  float avp = (humidity / 100.0) * svp;
-  return svp - avp;
-}
+void applyCommand(const BridgeCommand& command, uint32_t currentTime) {
+  BridgeAckStatus status = ACK_OK;
+  switch (command.type) {
+    case FRAME_SET_LIGHT_THRESHOLD:
+      control.lightThreshold = command.lightThreshold;
+      Serial.print(F("Light threshold set to: "));
+      Serial.println(control.lightThreshold);
+      break;
+    case FRAME_SET_PH_TARGET:
+      control.pHTarget = command.pHTarget;
+      Serial.print(F("pH target set to: "));
+      Serial.println(control.pHTarget, 2);
+      break;
+    case FRAME_MANUAL_PUMP:
+      status = startPumpPulse(command.pump, command.durationMs, currentTime);
+      break;
+    case FRAME_RESET_PH_FAULT:
+      control.resetPHFault();
+      Serial.println(F("pH fault reset, dosing resumed"));
+      break;
+    default:
+      status = ACK_REJECTED;
+      break;
+  }
 
-void updateVPDCycleInterval(float vpd) {
-  vpdCycleInterval = (vpd > 1.5) ? 6000 : (vpd < 0.8) ? 18000 : 12000;
-  Serial.print("New VPD cycle interval: ");
-  Serial.print(vpdCycleInterval / 1000);
-  Serial.println(" seconds");
+  uint8_t frame[BRIDGE_MAX_FRAME];
+  BRIDGE_SERIAL.write(frame, encodeAck(command.sequence, command.type, status, frame));
 }
 
-float measureWaterLevel() {
-  digitalWrite(TRIG_PIN, LOW);
-  delayMicroseconds(2);
-  digitalWrite(TRIG_PIN, HIGH);
-  delayMicroseconds(10);
-  digitalWrite(TRIG_PIN, LOW);
-  
-  long duration = pulseIn(ECHO_PIN, HIGH);
-  return RESERVOIR_HEIGHT - (duration * 0.034 / 2);
+// Whether the VPD or pH control currently has this pump's relay switched on
+bool pumpInUse(BridgePump pump) {
+  switch (pump) {
+    case PUMP_VPD:
+      return control.isVPDPumping;
+    case PUMP_ACID:
+      return control.isPHAdjusting && control.isDosingAcid;
+    case PUMP_BASE:
+      return control.isPHAdjusting && !control.isDosingAcid;
+    case PUMP_MIX:
+      return control.isPHMixing;
+  }
+  return false;
 }
 
-float calculateReservoirVolume(float waterLevel) {
-  return PI * RESERVOIR_RADIUS * RESERVOIR_RADIUS * waterLevel / 1000.0;
+// The ControlState flag that hands this pump's relay to a manual pulse
+bool& manualPulseFlag(BridgePump pump) {
+  switch (pump) {
+    case PUMP_ACID:
+      return control.acidManualPulse;
+    case PUMP_BASE:
+      return control.baseManualPulse;
+    case PUMP_MIX:
+      return control.mixManualPulse;
+    default:
+      return control.vpdManualPulse;
+  }
 }
 
-void checkAndAdjustPH(unsigned long currentTime) {
-  lastpHCheckTime = currentTime;
-  float pH = readpH();
-  Serial.print("Current pH: ");
-  Serial.println(pH, 2);
-
-  if (pH < PH_LOWER_LIMIT || pH > PH_UPPER_LIMIT) {
-    if (pH < PH_TARGET) {
-      Serial.println("pH too low, activating base pump");
-      digitalWrite(BASE_PUMP_RELAY, LOW);
-    } else {
-      Serial.println("pH too high, activating acid pump");
-      digitalWrite(ACID_PUMP_RELAY, LOW);
+// Switch a pump on for `durationMs`; serviceBridge() switches it off again.
+// A pump the automatic control is running is left alone, and acid and base
+// never run together: a reagent pulse is refused during an automatic dose or
+// while the other reagent is being pulsed.
+BridgeAckStatus startPumpPulse(BridgePump pump, uint16_t durationMs, uint32_t currentTime) {
+  if (pumpInUse(pump)) {
+    return ACK_BUSY;
+  }
+  if (pump == PUMP_ACID || pump == PUMP_BASE) {
+    bool otherPulsed = pump == PUMP_ACID ? control.baseManualPulse : control.acidManualPulse;
+    if (control.isPHAdjusting || otherPulsed) {
+      return ACK_BUSY;
     }
-    isPHAdjusting = true;
-    
-    Serial.print("Dosing for ");
-    Serial.print(ph_pump_duration);
-    Serial.println(" ms based on current reservoir volume");
-  } else {
-    Serial.println("pH within acceptable range");
+    control.forgetLastDose();
   }
+  pulseActive[pump] = true;
+  pulseStartTime[pump] = currentTime;
+  pulseDuration[pump] = min(durationMs, (uint16_t)MANUAL_PULSE_MAX);
+  manualPulseFlag(pump) = true;  // The automatic control must not switch the relay meanwhile
+  digitalWrite(pumpRelays[pump], RELAY_ON);
+  Serial.print(F("Manual pump pulse: "));
+  Serial.print(pulseDuration[pump]);
+  Serial.println(F(" ms"));
+  scheduler.runSoon(serviceBridge);
+  return ACK_OK;
 }
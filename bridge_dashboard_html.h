@@ -0,0 +1,102 @@
+// Generated by tools/embed_html.py from web/bridge_dashboard.html - do not edit
+// 3326 bytes minified, 1396 bytes gzipped
+#ifndef BRIDGE_DASHBOARD_HTML_H
+#define BRIDGE_DASHBOARD_HTML_H
+
+#include <Arduino.h>
+
+#define BRIDGE_DASHBOARD_ETAG "\"ca16048ba850a220\""
+
+const size_t BRIDGE_DASHBOARD_GZ_LEN = 1396;
+const uint8_t BRIDGE_DASHBOARD_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x57, 0xff, 0x6f, 0x9b, 0x38,
+  0x14, 0xff, 0x9d, 0xbf, 0xc2, 0xc7, 0x76, 0x02, 0x24, 0x20, 0x24, 0x69, 0xa6, 0x96, 0x7c, 0x91,
+  0xba, 0x6e, 0xbb, 0xee, 0xb4, 0x5b, 0xab, 0x5b, 0x6e, 0xd2, 0x5d, 0x55, 0x69, 0x06, 0x4c, 0xf0,
+  0x06, 0x06, 0xd9, 0x26, 0x6d, 0xae, 0xea, 0xff, 0x7e, 0xcf, 0x06, 0x12, 0x92, 0xa6, 0xda, 0x4d,
+  0x3a, 0x9d, 0xaa, 0x62, 0xb0, 0x9f, 0xdf, 0xfb, 0xbc, 0x6f, 0x1f, 0x3b, 0xb3, 0x9f, 0xde, 0x5c,
+  0x5d, 0x2c, 0xff, 0xbc, 0x7e, 0x8b, 0x32, 0x59, 0xe4, 0x0b, 0x63, 0xa6, 0x06, 0x94, 0x63, 0xb6,
+  0x9a, 0x9b, 0x84, 0x99, 0x6a, 0x82, 0xe0, 0x04, 0x86, 0x82, 0x48, 0x8c, 0xe2, 0x0c, 0x73, 0x41,
+  0xe4, 0xdc, 0xfc, 0x63, 0xf9, 0xce, 0x3b, 0x35, 0xbb, 0x69, 0x86, 0x0b, 0x32, 0x37, 0xd7, 0x94,
+  0xdc, 0x55, 0x25, 0x97, 0x26, 0x8a, 0x4b, 0x26, 0x09, 0x03, 0xb1, 0x3b, 0x9a, 0xc8, 0x6c, 0x9e,
+  0x90, 0x35, 0x8d, 0x89, 0xa7, 0x3f, 0x5c, 0x44, 0x19, 0x95, 0x14, 0xe7, 0x9e, 0x88, 0x71, 0x4e,
+  0xe6, 0x43, 0x3f, 0x50, 0x6a, 0x24, 0x95, 0x39, 0x59, 0x9c, 0x13, 0x5e, 0x56, 0x25, 0xa3, 0x31,
+  0xba, 0x00, 0x0d, 0xbc, 0xcc, 0xd1, 0x35, 0x66, 0x24, 0x9f, 0x0d, 0x9a, 0x65, 0x63, 0x26, 0xe4,
+  0x46, 0x8d, 0x51, 0x99, 0x6c, 0xd0, 0x83, 0x91, 0x82, 0x90, 0x97, 0xe2, 0x82, 0xe6, 0x9b, 0x10,
+  0x9d, 0x73, 0x50, 0xea, 0x22, 0x81, 0x99, 0xf0, 0x04, 0xe1, 0x34, 0x9d, 0x1a, 0x11, 0x8e, 0xbf,
+  0xad, 0x78, 0x59, 0xb3, 0x24, 0x44, 0x39, 0x65, 0x04, 0x73, 0x6f, 0xc5, 0x71, 0x42, 0x01, 0x9a,
+  0x3d, 0x1c, 0x05, 0x09, 0x59, 0xb9, 0xe8, 0xc5, 0xe9, 0x49, 0x8a, 0xa3, 0x00, 0x05, 0x3f, 0xab,
+  0xf7, 0x34, 0x19, 0xa7, 0x27, 0x68, 0x18, 0x04, 0x3f, 0x3b, 0x53, 0xa3, 0xc0, 0x7c, 0x45, 0x59,
+  0x88, 0x82, 0xa9, 0x51, 0xe1, 0x24, 0xa1, 0x6c, 0x15, 0xa2, 0x51, 0x50, 0xdd, 0x4f, 0x8d, 0xb8,
+  0xcc, 0x4b, 0x1e, 0xa2, 0x17, 0xe3, 0xf1, 0x78, 0x6a, 0x3c, 0x1a, 0xbe, 0xf2, 0x17, 0x83, 0x01,
+  0x0e, 0xa0, 0x0a, 0x7c, 0xdf, 0x78, 0x1a, 0xa2, 0xd3, 0x40, 0x4b, 0x6f, 0xf5, 0x20, 0x5c, 0xcb,
+  0xb2, 0x0f, 0xcb, 0x6b, 0x15, 0xf1, 0x55, 0x84, 0xed, 0xd1, 0x64, 0xe2, 0xa2, 0xdd, 0x23, 0xf0,
+  0xcf, 0x00, 0x43, 0x54, 0xf2, 0x84, 0x70, 0x4f, 0xa1, 0xae, 0x45, 0x08, 0xc8, 0x94, 0xc2, 0x03,
+  0x34, 0x51, 0x79, 0xef, 0x89, 0x0c, 0x27, 0xe5, 0x9d, 0xb2, 0x11, 0x68, 0xa1, 0x46, 0x65, 0xe0,
+  0xea, 0x3f, 0x7f, 0xe8, 0x28, 0x98, 0xd9, 0x10, 0xe0, 0x75, 0xd0, 0x47, 0xf1, 0x98, 0x4c, 0xc0,
+  0x33, 0x49, 0xee, 0xa5, 0x87, 0x73, 0xba, 0x02, 0x80, 0x31, 0x04, 0x86, 0x70, 0xed, 0x91, 0x20,
+  0x4c, 0x94, 0x2a, 0x5c, 0x34, 0x81, 0x4d, 0x09, 0x15, 0x55, 0x8e, 0x21, 0xc8, 0xea, 0x7b, 0x6a,
+  0xa8, 0xa7, 0x27, 0x49, 0x01, 0x73, 0x92, 0x28, 0x1f, 0xea, 0x82, 0x01, 0x38, 0x4e, 0x2a, 0x82,
+  0xa5, 0xad, 0x9c, 0xf4, 0x52, 0x2a, 0x5d, 0x54, 0x50, 0x06, 0xd1, 0xb0, 0x47, 0x2a, 0x0c, 0x2e,
+  0x1a, 0xa6, 0xdc, 0x01, 0x1c, 0x2b, 0x5c, 0x75, 0xc0, 0x9b, 0xc0, 0x78, 0x51, 0x29, 0x65, 0x59,
+  0x74, 0x93, 0x3b, 0xe3, 0x31, 0xe6, 0xca, 0xf8, 0xd3, 0x70, 0xbd, 0x48, 0xd3, 0xf4, 0x49, 0x68,
+  0x26, 0x7b, 0x91, 0x19, 0xea, 0xcf, 0x63, 0xce, 0xed, 0x47, 0x6b, 0x04, 0xa1, 0x9a, 0x1c, 0x0f,
+  0x57, 0x07, 0x63, 0x8d, 0xf3, 0x9a, 0x74, 0xd5, 0x26, 0xe8, 0xdf, 0x04, 0x90, 0x9e, 0x28, 0xed,
+  0x7a, 0xe2, 0x8e, 0xd0, 0x55, 0x26, 0x43, 0x14, 0x95, 0x79, 0xb2, 0x4b, 0xb5, 0x4e, 0x41, 0xb0,
+  0xad, 0x0d, 0xa8, 0x64, 0xd1, 0x0f, 0x63, 0x9a, 0x13, 0xb5, 0x1f, 0x9e, 0xde, 0x1d, 0x57, 0xf1,
+  0x50, 0xcf, 0xa9, 0xf1, 0xb5, 0x16, 0x92, 0xa6, 0x1b, 0xaf, 0x6d, 0x9f, 0x10, 0x89, 0x0a, 0x43,
+  0xdf, 0x60, 0xed, 0x7c, 0x5f, 0x99, 0x47, 0x21, 0xfa, 0xba, 0xd6, 0x76, 0xe6, 0xd4, 0x3a, 0x65,
+  0x55, 0x2d, 0x6f, 0xe4, 0xa6, 0x82, 0x6e, 0xe4, 0xd0, 0xc2, 0xc4, 0xbc, 0x05, 0xa9, 0xb6, 0x1a,
+  0x47, 0x41, 0x2b, 0x15, 0xd5, 0x10, 0x6f, 0x76, 0x3c, 0xb2, 0xe3, 0x93, 0xb3, 0xd3, 0x24, 0xda,
+  0x56, 0xf8, 0x5d, 0x06, 0x96, 0xba, 0x50, 0x87, 0x88, 0x95, 0x8c, 0xf4, 0x83, 0xac, 0xbc, 0xec,
+  0x6a, 0xf0, 0x69, 0x32, 0xe2, 0x9a, 0x0b, 0xa5, 0xa4, 0x2a, 0x69, 0x13, 0x7a, 0x09, 0x98, 0x04,
+  0x34, 0x7f, 0x09, 0x90, 0x0f, 0x6d, 0x43, 0xbd, 0x8f, 0xc5, 0x0e, 0x5d, 0x98, 0x95, 0x6b, 0xdd,
+  0x4e, 0x47, 0x30, 0x8e, 0xce, 0x4e, 0x83, 0xe8, 0x4c, 0xc9, 0xce, 0x06, 0x2d, 0x21, 0xcc, 0x06,
+  0x2d, 0x4b, 0x29, 0x66, 0x80, 0x21, 0xa1, 0x6b, 0x14, 0xe7, 0x58, 0x88, 0xb9, 0xb9, 0xed, 0x4d,
+  0xcd, 0x65, 0xc3, 0xe7, 0x39, 0x06, 0xd6, 0xf6, 0x36, 0xf6, 0x5a, 0xc0, 0x44, 0x34, 0xe9, 0x26,
+  0x7e, 0x51, 0xdf, 0x8b, 0xd9, 0x00, 0x24, 0x9f, 0x1a, 0x52, 0x89, 0x36, 0x8f, 0x4e, 0xeb, 0x94,
+  0xa9, 0xa5, 0x1c, 0x47, 0x24, 0x47, 0x69, 0xc9, 0xe7, 0x66, 0xae, 0x4a, 0x67, 0x99, 0x71, 0x22,
+  0x32, 0xa8, 0x1e, 0x73, 0xf1, 0x41, 0x7d, 0xa3, 0xed, 0x44, 0x38, 0x1b, 0x68, 0x61, 0xd8, 0xa4,
+  0x13, 0x8b, 0xfa, 0x89, 0xd5, 0x88, 0x0e, 0x14, 0xa8, 0x86, 0x9b, 0x9b, 0x01, 0x8c, 0xf8, 0x7e,
+  0x6e, 0x0e, 0x83, 0xd1, 0xd8, 0x44, 0xba, 0x7a, 0xe7, 0xe6, 0x38, 0xd0, 0x34, 0x0b, 0x05, 0xc5,
+  0x8e, 0xec, 0xfc, 0xac, 0x84, 0xcc, 0x05, 0x08, 0x41, 0x44, 0x41, 0x44, 0x05, 0xf4, 0x39, 0xff,
+  0x8e, 0x39, 0x52, 0x5d, 0x2e, 0xa1, 0x12, 0x89, 0x34, 0x17, 0xd5, 0x25, 0x6a, 0x5e, 0xbf, 0x0f,
+  0x7e, 0xbb, 0xa9, 0x81, 0x3d, 0xf1, 0x27, 0x2d, 0xf0, 0x57, 0xea, 0x4d, 0x48, 0x52, 0x81, 0x2f,
+  0xfe, 0x70, 0xeb, 0xc2, 0x2b, 0x7f, 0xdf, 0x85, 0x6e, 0x7f, 0x0b, 0x1e, 0x96, 0x7f, 0x00, 0x7c,
+  0xdb, 0x03, 0x25, 0x8b, 0x73, 0x1a, 0x7f, 0x9b, 0x9b, 0x05, 0x66, 0x35, 0xce, 0xaf, 0xeb, 0xa2,
+  0xb2, 0xad, 0x75, 0x95, 0x58, 0x8e, 0xb9, 0xf8, 0x7c, 0xfd, 0x06, 0xa9, 0x89, 0xd9, 0xa0, 0x11,
+  0xfe, 0xce, 0x2e, 0x1c, 0x53, 0xbd, 0xed, 0x1c, 0xc6, 0x1f, 0xd9, 0x17, 0x61, 0x41, 0xd4, 0xbe,
+  0xd7, 0x30, 0x7e, 0x6f, 0x5f, 0x5d, 0x25, 0xc0, 0xb8, 0x6d, 0xdd, 0xda, 0x16, 0x64, 0x8f, 0xc8,
+  0xeb, 0xcb, 0x77, 0xb8, 0xce, 0xa5, 0xe5, 0x22, 0xc9, 0x6b, 0x02, 0x8a, 0x7e, 0x57, 0xb3, 0x08,
+  0x12, 0xa1, 0xe7, 0x7b, 0xda, 0xda, 0xa8, 0xec, 0x0f, 0x22, 0xe6, 0xb4, 0x92, 0x0b, 0x23, 0xad,
+  0x59, 0xac, 0x3a, 0x13, 0x35, 0x36, 0x3e, 0xe9, 0x5a, 0x7f, 0x83, 0x25, 0xb6, 0x1d, 0xc5, 0x7d,
+  0x44, 0xc6, 0x99, 0x6d, 0x0d, 0x60, 0x09, 0x5b, 0x8e, 0xe1, 0xcb, 0x8c, 0x30, 0x1b, 0xcc, 0x43,
+  0x23, 0x01, 0xea, 0xf9, 0x02, 0x75, 0xef, 0xfe, 0x57, 0x51, 0x32, 0xdb, 0xe9, 0x44, 0x94, 0xbc,
+  0x5a, 0x56, 0xe7, 0x0e, 0x13, 0x12, 0xed, 0x5a, 0x08, 0xcd, 0x51, 0x52, 0xc6, 0x75, 0x01, 0x3c,
+  0xe7, 0x43, 0x12, 0xdf, 0xe6, 0x44, 0xbd, 0xbe, 0xde, 0xbc, 0x4f, 0x6c, 0x6b, 0x27, 0x65, 0x01,
+  0x13, 0xef, 0xbe, 0x7c, 0xca, 0xa0, 0x8f, 0x2f, 0x97, 0xbf, 0x7d, 0x80, 0xdd, 0x96, 0xa5, 0x18,
+  0x98, 0x23, 0xbb, 0xd1, 0x7c, 0xf3, 0x8d, 0x6c, 0xdc, 0xa6, 0x54, 0x6e, 0x51, 0x99, 0xa2, 0xab,
+  0xe8, 0x2b, 0x89, 0xa5, 0x0f, 0x3a, 0x39, 0x25, 0x42, 0x03, 0x71, 0x9c, 0x2d, 0x0e, 0x7d, 0xb4,
+  0xf4, 0x10, 0xc4, 0x1c, 0x4e, 0x2e, 0xd2, 0x82, 0xb0, 0x2d, 0x08, 0x8d, 0xb2, 0xac, 0xa4, 0x7c,
+  0x5d, 0x40, 0x1f, 0xe1, 0x82, 0xa3, 0x6c, 0xf6, 0x4e, 0x26, 0xab, 0x5d, 0xef, 0x63, 0xfa, 0x02,
+  0x0c, 0x33, 0x5e, 0xbc, 0x7c, 0x00, 0x2c, 0x3e, 0x9c, 0x86, 0x39, 0xb0, 0xb7, 0x3d, 0xb0, 0x6f,
+  0xce, 0xbd, 0xbf, 0x6e, 0x9d, 0x01, 0x5c, 0x36, 0x2c, 0xf4, 0x72, 0x68, 0x39, 0x3e, 0x40, 0x2a,
+  0x6c, 0xe7, 0x11, 0x28, 0x67, 0x7c, 0x94, 0x72, 0xd6, 0x4d, 0x45, 0xbf, 0x7c, 0xd0, 0x2f, 0x8f,
+  0x6d, 0xaa, 0xbe, 0xec, 0x85, 0x02, 0x57, 0x15, 0x61, 0xc9, 0x45, 0x46, 0xf3, 0xc4, 0x56, 0x38,
+  0xf4, 0x91, 0xf5, 0xa8, 0x9f, 0x07, 0xa9, 0xec, 0xca, 0xa5, 0x6d, 0x81, 0x36, 0x48, 0xfd, 0xac,
+  0xb6, 0x2b, 0x50, 0x42, 0x70, 0xa4, 0x10, 0x99, 0x95, 0x70, 0x5f, 0xb2, 0xae, 0xaf, 0x3e, 0x2d,
+  0x2d, 0xd7, 0x50, 0xbc, 0x4a, 0x38, 0x50, 0xfa, 0x83, 0x61, 0x5d, 0x34, 0xe7, 0x92, 0xb7, 0x84,
+  0x56, 0xb6, 0x40, 0x04, 0x30, 0x40, 0x5d, 0x62, 0x65, 0x6b, 0xa0, 0xf2, 0x0e, 0xe2, 0x8f, 0xae,
+  0xbe, 0x9c, 0x85, 0xe8, 0xd7, 0x4f, 0x57, 0x1f, 0x7d, 0x01, 0x9e, 0xb2, 0x15, 0x1c, 0x69, 0xf6,
+  0x03, 0xba, 0x69, 0xad, 0xdc, 0x86, 0x0d, 0x00, 0xf4, 0xe8, 0xb8, 0x87, 0x80, 0x7b, 0x7d, 0x51,
+  0xc1, 0xe3, 0x7f, 0xc7, 0xb8, 0xb3, 0x0f, 0xa7, 0x16, 0x3c, 0x7b, 0x18, 0x9f, 0x2d, 0xd6, 0x7d,
+  0x26, 0x85, 0xec, 0xc2, 0xe9, 0xf8, 0x76, 0x0d, 0xcb, 0x1f, 0x28, 0x70, 0x18, 0xd4, 0x86, 0x6d,
+  0x69, 0x02, 0x04, 0xe4, 0x9d, 0x9f, 0xba, 0xa5, 0xfe, 0xa5, 0x42, 0xcd, 0x6e, 0xaa, 0x66, 0xe0,
+  0x2a, 0xd3, 0xfa, 0x06, 0x85, 0x26, 0x33, 0x2a, 0x7c, 0x1d, 0xc6, 0xa9, 0x71, 0x40, 0x0a, 0x07,
+  0x78, 0xdc, 0x9e, 0xac, 0x72, 0x04, 0xfe, 0x9f, 0xb5, 0xdc, 0x31, 0xea, 0x7f, 0xe0, 0xc4, 0x1e,
+  0x39, 0xff, 0x08, 0xfc, 0x2d, 0x86, 0x23, 0xc0, 0x81, 0xd7, 0xde, 0xab, 0x9b, 0x04, 0xcc, 0xd9,
+  0x87, 0x34, 0xe5, 0xa2, 0x49, 0x10, 0x04, 0x4e, 0xa7, 0xaf, 0xcf, 0x5f, 0x53, 0x75, 0x4f, 0x68,
+  0x69, 0x0e, 0xe8, 0xb0, 0xb9, 0x21, 0x0c, 0xf4, 0xcf, 0x9d, 0x7f, 0x00, 0xab, 0x6d, 0xd6, 0xc5,
+  0xfe, 0x0c, 0x00, 0x00,
+};
+
+#endif
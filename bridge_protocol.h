@@ -0,0 +1,309 @@
+#ifndef BRIDGE_PROTOCOL_H
+#define BRIDGE_PROTOCOL_H
+
+#include <Arduino.h>
+
+// Binary link between the Arduino controller (ard.cpp) and the ESP8266 web
+// bridge (web.cpp). Both sides include this header, so the layout only lives
+// here.
+//
+// Frame:  SYNC | type | length | payload[length] | crc16 (lo, hi)
+//
+// The CRC (CCITT, init 0xFFFF) covers type, length and payload. Multi-byte
+// fields are little-endian and values are fixed-point integers, so a full
+// telemetry sample is 24 bytes on the wire and nothing needs the heap to
+// decode. Anything that is not a valid frame, such as the Arduino's debug
+// prints sharing the UART, is skipped by the receiver.
+
+#define BRIDGE_SYNC 0xA5
+#define BRIDGE_HEADER_SIZE 3  // sync, type, length
+#define BRIDGE_CRC_SIZE 2
+#define BRIDGE_MAX_PAYLOAD 32
+#define BRIDGE_MAX_FRAME (BRIDGE_HEADER_SIZE + BRIDGE_MAX_PAYLOAD + BRIDGE_CRC_SIZE)
+
+enum BridgeFrameType : uint8_t {
+  FRAME_TELEMETRY = 0x01,            // Arduino -> bridge, SensorData
+  FRAME_ACK = 0x02,                  // Arduino -> bridge, uint8 sequence + uint8 type + uint8 status
+  FRAME_SET_LIGHT_THRESHOLD = 0x10,  // bridge -> Arduino, int16 raw ADC counts
+  FRAME_SET_PH_TARGET = 0x11,        // bridge -> Arduino, uint16 pH * 100
+  FRAME_MANUAL_PUMP = 0x12,          // bridge -> Arduino, uint8 pump + uint16 ms
+  FRAME_RESET_PH_FAULT = 0x13,       // bridge -> Arduino, sequence only
+};
+
+// Every command payload starts with a uint8 sequence number, echoed back in
+// the ACK so the bridge can match replies and time the round trip
+enum BridgeAckStatus : uint8_t {
+  ACK_OK = 0,
+  ACK_REJECTED = 1,  // Unknown type or malformed payload
+  ACK_BUSY = 2,      // Pump is being driven by the automatic control
+};
+
+enum BridgePump : uint8_t { PUMP_VPD, PUMP_ACID, PUMP_BASE, PUMP_MIX };
+
+// SensorData.flags
+#define SENSOR_CLIMATE_VALID 0x01
+#define SENSOR_MISTING 0x02
+#define SENSOR_ROTATING 0x04
+#define SENSOR_PH_ADJUSTING 0x08
+#define SENSOR_PH_FAULT 0x10  // Dosing stopped until FRAME_RESET_PH_FAULT
+
+// One telemetry sample. Climate values are NaN when SENSOR_CLIMATE_VALID is clear.
+struct SensorData {
+  uint16_t sequence;
+  float temperature;
+  float humidity;
+  float vpd;
+  float pH;
+  float waterLevel;
+  float reservoirVolume;
+  int lightIntensity;
+  uint8_t flags;
+};
+
+#define TELEMETRY_PAYLOAD_SIZE 19
+
+// A decoded command frame; only the fields for `type` are meaningful
+struct BridgeCommand {
+  BridgeFrameType type;
+  uint8_t sequence;
+  int lightThreshold;
+  float pHTarget;
+  BridgePump pump;
+  uint16_t durationMs;
+};
+
+inline uint16_t bridgeCrc16(uint16_t crc, uint8_t byte) {
+  crc ^= (uint16_t)byte << 8;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+inline void bridgePut16(uint8_t* out, uint16_t value) {
+  out[0] = value & 0xff;
+  out[1] = value >> 8;
+}
+
+inline uint16_t bridgeGet16(const uint8_t* in) {
+  return in[0] | ((uint16_t)in[1] << 8);
+}
+
+// Fixed-point helpers; values outside the field's range are clamped
+inline uint16_t bridgeToFixed(float value, float scale, float lo, float hi) {
+  return (uint16_t)(int16_t)lroundf(constrain(value, lo, hi) * scale);
+}
+
+// Wrap `length` payload bytes into a frame in `out` (BRIDGE_MAX_FRAME bytes).
+// Returns the frame length, or 0 if the payload is too long.
+inline size_t encodeBridgeFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint8_t* out) {
+  if (length > BRIDGE_MAX_PAYLOAD) {
+    return 0;
+  }
+  out[0] = BRIDGE_SYNC;
+  out[1] = type;
+  out[2] = length;
+  memcpy(out + BRIDGE_HEADER_SIZE, payload, length);
+
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 1; i < BRIDGE_HEADER_SIZE + length; i++) {
+    crc = bridgeCrc16(crc, out[i]);
+  }
+  bridgePut16(out + BRIDGE_HEADER_SIZE + length, crc);
+  return BRIDGE_HEADER_SIZE + length + BRIDGE_CRC_SIZE;
+}
+
+// Check the CRC of a complete frame starting at its sync byte
+inline bool verifyBridgeFrame(const uint8_t* frame, size_t frameLength) {
+  if (frameLength < BRIDGE_HEADER_SIZE + BRIDGE_CRC_SIZE || frame[0] != BRIDGE_SYNC ||
+      frame[2] != frameLength - BRIDGE_HEADER_SIZE - BRIDGE_CRC_SIZE) {
+    return false;
+  }
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 1; i < frameLength - BRIDGE_CRC_SIZE; i++) {
+    crc = bridgeCrc16(crc, frame[i]);
+  }
+  return crc == bridgeGet16(frame + frameLength - BRIDGE_CRC_SIZE);
+}
+
+// Byte-at-a-time frame parser over a fixed buffer, for reading the link from
+// loop() without ever waiting on the UART. Bytes that do not start a frame
+// are dropped; a frame with an impossible length or a bad CRC costs one byte,
+// and parsing restarts at the next sync byte, so the assembler resyncs in the
+// middle of noise or after a lost byte.
+class FrameAssembler {
+public:
+  // Feed one received byte. Returns true when a complete, CRC-checked frame
+  // is available through type()/payload(); it stays valid until the next push().
+  bool push(uint8_t byte) {
+    if (frameLength > 0) {
+      drop(frameLength);
+      frameLength = 0;
+    }
+    if (length == sizeof(buffer)) {
+      drop(1);
+    }
+    buffer[length++] = byte;
+    return parse();
+  }
+
+  uint8_t type() const {
+    return buffer[1];
+  }
+
+  const uint8_t* payload() const {
+    return buffer + BRIDGE_HEADER_SIZE;
+  }
+
+  uint8_t payloadLength() const {
+    return buffer[2];
+  }
+
+  uint32_t frames = 0;
+  uint32_t crcErrors = 0;
+  uint32_t skippedBytes = 0;
+
+private:
+  bool parse() {
+    for (;;) {
+      size_t start = 0;
+      while (start < length && buffer[start] != BRIDGE_SYNC) {
+        start++;
+      }
+      if (start > 0) {
+        skippedBytes += start;
+        drop(start);
+      }
+      if (length < BRIDGE_HEADER_SIZE) {
+        return false;
+      }
+      if (buffer[2] > BRIDGE_MAX_PAYLOAD) {
+        skippedBytes++;
+        drop(1);
+        continue;
+      }
+
+      size_t needed = BRIDGE_HEADER_SIZE + buffer[2] + BRIDGE_CRC_SIZE;
+      if (length < needed) {
+        return false;
+      }
+      if (verifyBridgeFrame(buffer, needed)) {
+        frameLength = needed;
+        frames++;
+        return true;
+      }
+      crcErrors++;
+      drop(1);
+    }
+  }
+
+  void drop(size_t count) {
+    memmove(buffer, buffer + count, length - count);
+    length -= count;
+  }
+
+  uint8_t buffer[BRIDGE_MAX_FRAME];
+  size_t length = 0;
+  size_t frameLength = 0;  // Bytes of the frame last returned, dropped on the next push()
+};
+
+inline size_t encodeTelemetry(const SensorData& data, uint8_t* out) {
+  uint8_t payload[TELEMETRY_PAYLOAD_SIZE];
+  bool climate = data.flags & SENSOR_CLIMATE_VALID;
+  bridgePut16(payload + 0, data.sequence);
+  bridgePut16(payload + 2, climate ? bridgeToFixed(data.temperature, 100, -40, 125) : 0);  // 0.01 °C, signed
+  bridgePut16(payload + 4, climate ? bridgeToFixed(data.humidity, 100, 0, 100) : 0);       // 0.01 %RH
+  bridgePut16(payload + 6, climate ? bridgeToFixed(data.vpd, 1000, 0, 30) : 0);            // 0.001 kPa
+  bridgePut16(payload + 8, bridgeToFixed(data.pH, 1000, 0, 14));                           // 0.001 pH
+  bridgePut16(payload + 10, bridgeToFixed(data.waterLevel, 100, 0, 300));                  // 0.01 cm
+  bridgePut16(payload + 12, bridgeToFixed(data.reservoirVolume, 100, 0, 320));             // 0.01 L
+  bridgePut16(payload + 14, constrain(data.lightIntensity, 0, 65535));
+  payload[16] = data.flags;
+  payload[17] = 0;  // Reserved
+  payload[18] = 0;
+  return encodeBridgeFrame(FRAME_TELEMETRY, payload, TELEMETRY_PAYLOAD_SIZE, out);
+}
+
+inline bool decodeTelemetry(const uint8_t* payload, uint8_t length, SensorData& data) {
+  if (length < TELEMETRY_PAYLOAD_SIZE) {
+    return false;
+  }
+  data.flags = payload[16];
+  bool climate = data.flags & SENSOR_CLIMATE_VALID;
+  data.sequence = bridgeGet16(payload + 0);
+  data.temperature = climate ? (int16_t)bridgeGet16(payload + 2) / 100.0 : NAN;
+  data.humidity = climate ? bridgeGet16(payload + 4) / 100.0 : NAN;
+  data.vpd = climate ? bridgeGet16(payload + 6) / 1000.0 : NAN;
+  data.pH = bridgeGet16(payload + 8) / 1000.0;
+  data.waterLevel = bridgeGet16(payload + 10) / 100.0;
+  data.reservoirVolume = bridgeGet16(payload + 12) / 100.0;
+  data.lightIntensity = bridgeGet16(payload + 14);
+  return true;
+}
+
+inline size_t encodeLightThreshold(uint8_t sequence, int threshold, uint8_t* out) {
+  uint8_t payload[3];
+  payload[0] = sequence;
+  bridgePut16(payload + 1, (uint16_t)(int16_t)constrain(threshold, -32768, 32767));
+  return encodeBridgeFrame(FRAME_SET_LIGHT_THRESHOLD, payload, sizeof(payload), out);
+}
+
+inline size_t encodePHTarget(uint8_t sequence, float target, uint8_t* out) {
+  uint8_t payload[3];
+  payload[0] = sequence;
+  bridgePut16(payload + 1, bridgeToFixed(target, 100, 0, 14));
+  return encodeBridgeFrame(FRAME_SET_PH_TARGET, payload, sizeof(payload), out);
+}
+
+inline size_t encodeManualPump(uint8_t sequence, BridgePump pump, uint16_t durationMs, uint8_t* out) {
+  uint8_t payload[4];
+  payload[0] = sequence;
+  payload[1] = pump;
+  bridgePut16(payload + 2, durationMs);
+  return encodeBridgeFrame(FRAME_MANUAL_PUMP, payload, sizeof(payload), out);
+}
+
+inline size_t encodeResetPHFault(uint8_t sequence, uint8_t* out) {
+  return encodeBridgeFrame(FRAME_RESET_PH_FAULT, &sequence, 1, out);
+}
+
+inline size_t encodeAck(uint8_t sequence, uint8_t type, BridgeAckStatus status, uint8_t* out) {
+  uint8_t payload[3] = {sequence, type, status};
+  return encodeBridgeFrame(FRAME_ACK, payload, sizeof(payload), out);
+}
+
+// Decode any bridge -> Arduino frame. Returns false for unknown types or
+// short payloads; `command.sequence` is still set when the payload has one.
+inline bool decodeCommand(uint8_t type, const uint8_t* payload, uint8_t length, BridgeCommand& command) {
+  command.type = (BridgeFrameType)type;
+  if (length < 1) {
+    return false;
+  }
+  command.sequence = payload[0];
+  switch (type) {
+    case FRAME_SET_LIGHT_THRESHOLD:
+      if (length < 3) {
+        return false;
+      }
+      command.lightThreshold = (int16_t)bridgeGet16(payload + 1);
+      return true;
+    case FRAME_SET_PH_TARGET:
+      if (length < 3) {
+        return false;
+      }
+      command.pHTarget = bridgeGet16(payload + 1) / 100.0;
+      return true;
+    case FRAME_MANUAL_PUMP:
+      if (length < 4 || payload[1] > PUMP_MIX) {
+        return false;
+      }
+      command.pump = (BridgePump)payload[1];
+      command.durationMs = bridgeGet16(payload + 2);
+      return true;
+    case FRAME_RESET_PH_FAULT:
+      return true;
+  }
+  return false;
+}
+
+#endif
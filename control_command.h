@@ -0,0 +1,74 @@
+#ifndef CONTROL_COMMAND_H
+#define CONTROL_COMMAND_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// The ESP32's /control body, e.g. {"zone":"2","pHTarget":"6.2"}, parsed into
+// one setpoint change for the control loop. "zone" picks the zone by name;
+// without it the command is for the first. The first setting key found wins.
+
+#define CONTROL_JSON_CAPACITY 256
+
+enum ControlCommandType : uint8_t { SET_LIGHT_THRESHOLD, SET_PH_TARGET, SET_VPD_LOW, SET_VPD_HIGH, RESET_PH_FAULT };
+struct ControlCommand {
+  ControlCommandType type;
+  uint8_t zone;  // Index into the zone names
+  float value;
+};
+
+enum ControlParseResult : uint8_t {
+  CONTROL_OK,
+  CONTROL_INVALID_JSON,
+  CONTROL_UNKNOWN_ZONE,
+  CONTROL_UNKNOWN_SETTING,
+};
+
+// The dashboards post slider values as strings, e.g. {"pHTarget":"6.2"}
+inline float controlNumber(JsonVariantConst value) {
+  return value.is<const char*>() ? atof(value.as<const char*>()) : value.as<float>();
+}
+
+inline ControlParseResult parseControlCommand(const char* body, const char* const* zoneNames, uint8_t zoneCount,
+                                              ControlCommand& command) {
+  DynamicJsonDocument doc(CONTROL_JSON_CAPACITY);
+  if (deserializeJson(doc, body)) {
+    return CONTROL_INVALID_JSON;
+  }
+
+  command.zone = 0;
+  if (doc.containsKey("zone")) {
+    const char* name = doc["zone"] | "";
+    command.zone = zoneCount;
+    for (uint8_t i = 0; i < zoneCount; i++) {
+      if (strcmp(name, zoneNames[i]) == 0) {
+        command.zone = i;
+      }
+    }
+    if (command.zone == zoneCount) {
+      return CONTROL_UNKNOWN_ZONE;
+    }
+  }
+
+  command.value = 0;
+  if (doc.containsKey("lightThreshold")) {
+    command.type = SET_LIGHT_THRESHOLD;
+    command.value = controlNumber(doc["lightThreshold"]);
+  } else if (doc.containsKey("pHTarget")) {
+    command.type = SET_PH_TARGET;
+    command.value = controlNumber(doc["pHTarget"]);
+  } else if (doc.containsKey("vpdLow")) {
+    command.type = SET_VPD_LOW;
+    command.value = controlNumber(doc["vpdLow"]);
+  } else if (doc.containsKey("vpdHigh")) {
+    command.type = SET_VPD_HIGH;
+    command.value = controlNumber(doc["vpdHigh"]);
+  } else if (doc.containsKey("resetPHFault")) {
+    command.type = RESET_PH_FAULT;
+  } else {
+    return CONTROL_UNKNOWN_SETTING;
+  }
+  return CONTROL_OK;
+}
+
+#endif
@@ -0,0 +1,612 @@
+#ifndef CONTROL_CORE_H
+#define CONTROL_CORE_H
+
+#include <Arduino.h>
+#include <AccelStepper.h>
+#include "job_scheduler.h"
+#include "sensor_snapshot.h"
+
+// Misting, pH dosing, reservoir and rotation control shared by the controller
+// sketches. Sampling is shared too (sensor_sampler.h); each sketch keeps its
+// own I/O (web server, bridge) and hands the core a board profile: a struct
+// of static constexpr members
+//
+//   pins      phPin, ldrPin, vpdRelay, acidRelay, baseRelay, mixRelay,
+//             trigPin, echoPin, stepPin, dirPin, sdaPin, sclPin (NO_PIN if unused)
+//   adcMax    full-scale raw ADC reading, e.g. 1023 or 4095
+//   pHAtZero, pHAtFullScale    probe calibration at raw 0 and at adcMax
+//   digitalLight               LDR module read with digitalRead(), HIGH in light
+//   defaultLightThreshold      raw reading above which the tray is rotated
+//   reservoirRadius, reservoirHeight    in cm
+//
+// Everything derived from the profile is constexpr, so pins, ADC scaling and
+// the light test fold at compile time, and a profile with two functions on
+// one pin does not compile.
+
+#define VPD_PUMP_DURATION 5000  // Longest mist pulse
+#define MIX_PUMP_DURATION 1000
+#define PH_CHECK_INTERVAL 30000
+#define PH_WAIT_INTERVAL 18000
+#define PH_LOWER_LIMIT 5.5
+#define PH_UPPER_LIMIT 6.5
+#define DOSAGE_RATE 0.00025  // 1 ml per 4 liters
+#define RESERVOIR_CHECK_INTERVAL 3600
+
+// PH_MODE_PI dosing. The dose is sized from the error and a learned gain:
+// pH moved per ms of pump per liter, kept separately for acid and base.
+#define PH_DEADBAND 0.15            // No dose while this close to the target
+#define PH_KP 0.8                   // Share of the error one dose corrects
+#define PH_KI 0.3                   // ... plus this share of the error left by earlier doses
+#define PH_INTEGRAL_LIMIT 1.0       // Summed error cap, in pH
+#define PH_INITIAL_GAIN 0.002       // A DOSAGE_RATE dose moves pH by about 0.5
+#define PH_GAIN_LEARNING_RATE 0.5   // Weight of each new gain observation
+#define PH_MIN_LEARNING_SHIFT 0.2   // Only learn from doses expected to move pH this much
+#define PH_MAX_GAIN_STEP 4.0        // ... nor from a shift more than this factor off that
+#define PH_MAX_UNANSWERED_DOSES 3   // Doses in a row that barely move pH before dosing stops
+#define PH_MAX_CORRECTION 0.5       // Largest shift one dose aims for, in pH
+#define PH_MIN_DOSE_MS 100
+#define PH_PI_MIX_DURATION 15000    // Mix until the dose has reached the probe
+
+// Misting. The duty cycle follows the VPD error against the middle of the
+// target band; a cycle is one pulse plus the gap to the next, both derived
+// from the duty.
+#define VPD_LOW 0.8                 // Default target band, kPa
+#define VPD_HIGH 1.2
+#define MIST_PERIOD 30000           // Cycle length while the pulse fits in it
+#define MIST_MIN_PULSE 1000         // Shortest pulse that reaches the nozzles
+#define MIST_MAX_INTERVAL 120000    // Longest cycle, so VPD is re-read at least this often
+#define MIST_MAX_DUTY 0.8
+#define MIST_KP 0.1                 // Duty per kPa of error
+#define MIST_KI 0.0005              // Duty per kPa of error per second
+#define MIST_PUMP_WATTS 24          // For the daily energy figure
+#define MIST_DAY_MS 86400000UL
+
+#define ROTATION_INTERVAL 5000
+#define STEPS_PER_REVOLUTION 200
+#define STEPS_90_DEGREES (STEPS_PER_REVOLUTION / 4)
+#define ROTATION_LOOP_BUDGET_US 2000  // Worst-case loop() pass allowed while the stepper is moving
+
+#define NO_PIN 0xFF
+
+// Relays are active LOW
+#define RELAY_ON LOW
+#define RELAY_OFF HIGH
+
+constexpr bool pinNotIn(uint8_t pin) {
+  return true;
+}
+
+template <typename... Pins>
+constexpr bool pinNotIn(uint8_t pin, uint8_t first, Pins... rest) {
+  return (pin == NO_PIN || pin != first) && pinNotIn(pin, rest...);
+}
+
+// True if no two of the pins are the same, ignoring NO_PIN
+constexpr bool pinsDistinct() {
+  return true;
+}
+
+template <typename... Pins>
+constexpr bool pinsDistinct(uint8_t first, Pins... rest) {
+  return pinNotIn(first, rest...) && pinsDistinct(rest...);
+}
+
+// Tetens saturation vapour pressure in kPa, 0.6108 * exp(17.27 T / (T + 237.3)),
+// in single precision only: the ESP32's FPU has no double support and the AVR
+// has no FPU at all. Over 0-50 °C it is a degree-5 Chebyshev fit in
+// u = (T - 25) / 25, evaluated in Horner form, which stays within 4e-5 kPa
+// (0.006 %) of the formula; host/bench checks this on every run. Outside
+// that range it falls back to expf(). NaN propagates.
+inline float saturationVaporPressure(float temperature) {
+  if (temperature < 0.0f || temperature > 50.0f) {
+    return 0.6108f * expf(17.27f * temperature / (temperature + 237.3f));
+  }
+  float u = (temperature - 25.0f) * 0.04f;
+  return 3.16781259f +
+         u * (4.71722794f + u * (3.06206822f + u * (1.11687493f + u * (0.243864194f + u * 0.0288787559f))));
+}
+
+inline float calculateVPD(float temperature, float humidity) {
+  float svp = saturationVaporPressure(temperature);
+  return svp - humidity * 0.01f * svp;
+}
+
+// Misting pump use over one day
+struct MistUsage {
+  uint32_t onMs = 0;
+  uint32_t spanMs = 0;  // Time covered so far
+
+  float duty() const {
+    return spanMs > 0 ? (float)onMs / spanMs : 0;
+  }
+
+  float energyWh() const {
+    return onMs * (MIST_PUMP_WATTS / 3600000.0f);
+  }
+};
+
+// The control state that does not depend on the board profile, so a sketch
+// running several profiles (one per zone) can reach it through one type
+struct ControlState {
+  enum PHMode {
+    PH_MODE_BANG_BANG,  // A fixed DOSAGE_RATE dose whenever pH leaves the limits
+    PH_MODE_PI,         // A dose sized from the error and the learned gain
+  };
+
+  // Called whenever published state changes (pumps, rotation, pH status)
+  void (*onChange)() = NULL;
+
+  int lightThreshold = 0;
+  float pHTarget = 6.0;
+  PHMode pHMode = PH_MODE_PI;
+
+  bool isVPDPumping = false;
+  bool isPHAdjusting = false;
+  bool isDosingAcid = false;  // Which reagent the current dose is pumping
+  bool isPHMixing = false;
+  bool isPHWaiting = false;
+  bool isRotating = false;
+  const char* phStatus = "stable";  // "stable", "adjusting", "completed" or "fault"
+
+  // Set by the sketch while a manual pulse holds a relay on. The automatic
+  // control never switches a relay it does not own, and does not start a
+  // dose while either reagent is being pulsed.
+  bool vpdManualPulse = false;
+  bool acidManualPulse = false;
+  bool baseManualPulse = false;
+  bool mixManualPulse = false;
+
+  float vpdLow = VPD_LOW;
+  float vpdHigh = VPD_HIGH;
+  float mistDuty = 0;              // Share of the time the misting pump runs
+  uint32_t vpdCycleInterval = MIST_PERIOD;
+  uint32_t mistPulse = 0;
+  MistUsage mistToday;
+  MistUsage mistYesterday;
+  uint32_t phPumpDuration = 0;  // The bang-bang dose for the current volume
+
+  // PH_MODE_PI state, public so sketches can report it
+  float pHIntegral = 0;
+  float acidGain = PH_INITIAL_GAIN;  // pH per ms of pump per liter
+  float baseGain = PH_INITIAL_GAIN;
+  uint8_t unansweredDoses = 0;  // Doses in a row that moved pH far less than expected
+  bool pHFault = false;         // Set after PH_MAX_UNANSWERED_DOSES; no dosing until reset
+
+  // Resume dosing once the probe has been checked. The fault only clears
+  // here, or with a reboot.
+  void resetPHFault() {
+    pHFault = false;
+    unansweredDoses = 0;
+    pHIntegral = 0;
+    phStatus = "stable";
+    if (onChange != NULL) {
+      onChange();
+    }
+  }
+};
+
+template <class Board>
+class ControlCore : public ControlState {
+  static_assert(pinsDistinct(Board::phPin, Board::ldrPin, Board::vpdRelay, Board::acidRelay,
+                             Board::baseRelay, Board::mixRelay, Board::trigPin, Board::echoPin,
+                             Board::stepPin, Board::dirPin, Board::sdaPin, Board::sclPin),
+                "Board profile assigns two functions to the same pin");
+  static_assert(Board::adcMax > 0, "Board profile needs the ADC full-scale reading");
+
+public:
+  ControlCore(SensorSnapshot& snapshot, AccelStepper& stepper) : snapshot(snapshot), stepper(stepper) {
+    lightThreshold = Board::defaultLightThreshold;
+  }
+
+  // Relays off before anything else runs
+  void begin() {
+    const uint8_t relays[] = {Board::vpdRelay, Board::acidRelay, Board::baseRelay, Board::mixRelay};
+    for (uint8_t relay : relays) {
+      pinMode(relay, OUTPUT);
+      digitalWrite(relay, RELAY_OFF);
+    }
+    mistDayStart = millis();
+  }
+
+  static constexpr float pHFromAdc(float raw) {
+    return Board::pHAtZero + raw * ((Board::pHAtFullScale - Board::pHAtZero) / Board::adcMax);
+  }
+
+  static constexpr float reservoirVolume(float waterLevel) {
+    return (float)(PI * Board::reservoirRadius * Board::reservoirRadius / 1000.0) * waterLevel;
+  }
+
+  static constexpr bool isLight(int lightReading, int threshold) {
+    return Board::digitalLight ? lightReading == HIGH : lightReading > threshold;
+  }
+
+  // Scheduler jobs; each returns the ms until it next needs to run
+
+  uint32_t runVPD(uint32_t currentTime) {
+    if (currentTime - lastVPDCycleTime >= vpdCycleInterval) {
+      lastVPDCycleTime = currentTime;
+      countMistDay(currentTime);
+
+      float humidity = snapshot.humidity;
+      float temperature = snapshot.temperature;
+      if (!isnan(humidity) && !isnan(temperature)) {
+        float vpd = calculateVPD(temperature, humidity);
+        updateMisting(vpd);
+
+        Serial.print(F("Humidity: "));
+        Serial.print(humidity, 1);
+        Serial.print(F("%, Temperature: "));
+        Serial.print(temperature, 1);
+        Serial.print(F("°C, VPD: "));
+        Serial.print(vpd, 2);
+        Serial.println(F(" kPa"));
+      } else {
+        Serial.println(F("Climate reading failed, keeping the last misting duty"));
+      }
+
+      if (mistPulse > 0) {
+        digitalWrite(Board::vpdRelay, RELAY_ON);
+        isVPDPumping = true;
+        changed();
+        Serial.println(F("VPD Pump activated"));
+      }
+    }
+
+    if (isVPDPumping && currentTime - lastVPDCycleTime >= mistPulse) {
+      // The relay is shared with manual pulses; the sketch switches it off when its pulse ends
+      if (!vpdManualPulse) {
+        digitalWrite(Board::vpdRelay, RELAY_OFF);
+      }
+      isVPDPumping = false;
+      mistToday.onMs += currentTime - lastVPDCycleTime;
+      changed();
+      Serial.println(F("VPD Pump deactivated"));
+    }
+
+    if (isVPDPumping) {
+      return timeUntil(currentTime, lastVPDCycleTime, mistPulse);
+    }
+    return timeUntil(currentTime, lastVPDCycleTime, vpdCycleInterval);
+  }
+
+  uint32_t runPH(uint32_t currentTime) {
+    if (!isPHAdjusting && !isPHMixing && !isPHWaiting && currentTime - lastpHCheckTime >= PH_CHECK_INTERVAL) {
+      phStatus = "stable";
+      checkAndAdjustPH(currentTime);
+    }
+
+    if (isPHWaiting && currentTime - lastpHCheckTime >= PH_WAIT_INTERVAL) {
+      isPHWaiting = false;
+      checkAndAdjustPH(currentTime);
+    }
+
+    if (isPHAdjusting && currentTime - lastpHCheckTime >= doseDuration) {
+      digitalWrite(isDosingAcid ? Board::acidRelay : Board::baseRelay, RELAY_OFF);
+      // A manual mix pulse already has the pump on; the sketch ends it
+      if (!mixManualPulse) {
+        digitalWrite(Board::mixRelay, RELAY_ON);
+      }
+      isPHAdjusting = false;
+      isPHMixing = true;
+      mixStartTime = currentTime;
+    }
+
+    // Mixing is its own phase instead of a delay() so other jobs keep running
+    if (isPHMixing && currentTime - mixStartTime >= mixDuration()) {
+      if (!mixManualPulse) {
+        digitalWrite(Board::mixRelay, RELAY_OFF);
+      }
+      isPHMixing = false;
+      isPHWaiting = true;
+      phStatus = "completed";
+      changed();
+      Serial.println(F("pH adjustment cycle completed, waiting before rechecking"));
+    }
+
+    if (isPHAdjusting) {
+      return timeUntil(currentTime, lastpHCheckTime, doseDuration);
+    }
+    if (isPHMixing) {
+      return timeUntil(currentTime, mixStartTime, mixDuration());
+    }
+    if (isPHWaiting) {
+      return timeUntil(currentTime, lastpHCheckTime, PH_WAIT_INTERVAL);
+    }
+    return timeUntil(currentTime, lastpHCheckTime, PH_CHECK_INTERVAL);
+  }
+
+  uint32_t runReservoir(uint32_t currentTime) {
+    if (currentTime - lastReservoirCheckTime >= RESERVOIR_CHECK_INTERVAL) {
+      lastReservoirCheckTime = currentTime;
+
+      float volume = snapshot.reservoirVolume;
+      Serial.print(F("Volume: "));
+      Serial.print(volume, 1);
+      Serial.println(F(" liters"));
+
+      phPumpDuration = volume * DOSAGE_RATE * 1000000;  // Convert to ms
+    }
+    return timeUntil(currentTime, lastReservoirCheckTime, RESERVOIR_CHECK_INTERVAL);
+  }
+
+  uint32_t runRotation(uint32_t currentTime) {
+    if (currentTime - lastRotationTime >= ROTATION_INTERVAL) {
+      lastRotationTime = currentTime;
+
+      Serial.print(F("Light intensity: "));
+      Serial.println(snapshot.lightIntensity);
+
+      if (isRotating) {
+        Serial.println(F("Previous rotation still in progress"));
+      } else if (isLight(snapshot.lightIntensity, lightThreshold)) {
+        // Only queue the move here; serviceRotation() steps it from loop()
+        stepper.moveTo(stepper.currentPosition() + STEPS_90_DEGREES);
+        isRotating = true;
+        rotationStartTime = currentTime;
+        rotationMaxLoopMicros = 0;
+        changed();
+      } else {
+        Serial.println(F("Insufficient light, not rotating"));
+      }
+    }
+    return timeUntil(currentTime, lastRotationTime, ROTATION_INTERVAL);
+  }
+
+  // Advance the current rotation by at most one step. AccelStepper needs
+  // run() at least once per step interval (1 ms at full speed), so call this
+  // from every loop() pass.
+  void serviceRotation() {
+    if (!isRotating) {
+      return;
+    }
+
+    stepper.run();
+    if (stepper.distanceToGo() == 0) {
+      isRotating = false;
+      changed();
+      Serial.print(F("Rotated 90 degrees in "));
+      Serial.print(millis() - rotationStartTime);
+      Serial.println(F(" ms"));
+      if (rotationMaxLoopMicros > ROTATION_LOOP_BUDGET_US) {
+        Serial.print(F("Warning: worst loop pass "));
+        Serial.print(rotationMaxLoopMicros);
+        Serial.println(F(" us exceeded the rotation budget"));
+      }
+    }
+  }
+
+  // A reagent pulsed by hand since the last PI dose would be taken for that
+  // dose's effect, so sketches call this when they start one
+  void forgetLastDose() {
+    lastDoseMsPerLiter = 0;
+  }
+
+  // Sketches that time their loop() report each pass here; a pass longer
+  // than the budget while rotating means the move is being slowed down
+  void recordLoopPass(uint32_t micros) {
+    if (isRotating && micros > rotationMaxLoopMicros) {
+      rotationMaxLoopMicros = micros;
+    }
+  }
+
+private:
+  void changed() {
+    if (onChange != NULL) {
+      onChange();
+    }
+  }
+
+  // PI on the VPD error: the integral settles on the duty that balances
+  // the canopy's drying, and is kept within the duty range (anti-windup) so
+  // a humid night leaves it at zero rather than deep below.
+  void updateMisting(float vpd) {
+    float error = vpd - (vpdLow + vpdHigh) / 2;
+    float seconds = vpdCycleInterval / 1000.0f;  // Since the last update
+    mistIntegral = constrain(mistIntegral + MIST_KI * error * seconds, 0.0f, (float)MIST_MAX_DUTY);
+    mistDuty = constrain(mistIntegral + MIST_KP * error, 0.0f, (float)MIST_MAX_DUTY);
+
+    // Pulse in proportion to the duty over MIST_PERIOD; past the pulse limits
+    // keep the pulse at the limit and stretch or shorten the cycle instead
+    mistPulse = mistDuty * MIST_PERIOD;
+    vpdCycleInterval = MIST_PERIOD;
+    if (mistPulse > VPD_PUMP_DURATION) {
+      mistPulse = VPD_PUMP_DURATION;
+      vpdCycleInterval = mistPulse / mistDuty;
+    } else if (mistPulse < MIST_MIN_PULSE) {
+      if (mistDuty * MIST_MAX_INTERVAL >= MIST_MIN_PULSE) {
+        mistPulse = MIST_MIN_PULSE;
+        vpdCycleInterval = mistPulse / mistDuty;
+      } else {
+        mistPulse = 0;
+      }
+    }
+
+    Serial.print(F("Misting duty "));
+    Serial.print(mistDuty * 100, 1);
+    Serial.print(F("%: "));
+    Serial.print(mistPulse);
+    Serial.print(F(" ms every "));
+    Serial.print(vpdCycleInterval / 1000.0, 1);
+    Serial.println(F(" s"));
+  }
+
+  // Roll the usage counter over once a day of millis() has passed
+  void countMistDay(uint32_t currentTime) {
+    mistToday.spanMs = currentTime - mistDayStart;
+    if (mistToday.spanMs < MIST_DAY_MS) {
+      return;
+    }
+    mistYesterday = mistToday;
+    mistToday = MistUsage();
+    mistDayStart = currentTime;
+
+    Serial.print(F("Misting over the last day: "));
+    Serial.print(mistYesterday.onMs / 60000.0, 1);
+    Serial.print(F(" min, "));
+    Serial.print(mistYesterday.duty() * 100, 1);
+    Serial.print(F("% duty, "));
+    Serial.print(mistYesterday.energyWh(), 1);
+    Serial.println(F(" Wh"));
+  }
+
+  uint32_t mixDuration() const {
+    return pHMode == PH_MODE_PI ? PH_PI_MIX_DURATION : MIX_PUMP_DURATION;
+  }
+
+  void checkAndAdjustPH(uint32_t currentTime) {
+    lastpHCheckTime = currentTime;
+    float pH = snapshot.pH;
+    Serial.print(F("Current pH: "));
+    Serial.println(pH, 2);
+
+    if (acidManualPulse || baseManualPulse) {
+      Serial.println(F("Manual reagent pulse running, not dosing"));
+    } else if (pHFault) {
+      phStatus = "fault";
+      Serial.println(F("pH dosing stopped, check the probe and reset"));
+    } else if (pHMode == PH_MODE_PI) {
+      learnGain(pH);
+      if (!pHFault) {
+        sizeDose(pH);
+      }
+    } else if (pH < PH_LOWER_LIMIT || pH > PH_UPPER_LIMIT) {
+      if (pH < pHTarget) {
+        Serial.println(F("pH too low, activating base pump"));
+        digitalWrite(Board::baseRelay, RELAY_ON);
+        isDosingAcid = false;
+      } else {
+        Serial.println(F("pH too high, activating acid pump"));
+        digitalWrite(Board::acidRelay, RELAY_ON);
+        isDosingAcid = true;
+      }
+      doseDuration = phPumpDuration;
+      isPHAdjusting = true;
+      phStatus = "adjusting";
+
+      Serial.print(F("Dosing for "));
+      Serial.print(phPumpDuration);
+      Serial.println(F(" ms based on current reservoir volume"));
+    } else {
+      Serial.println(F("pH within acceptable range"));
+    }
+    changed();
+  }
+
+  // Compare the last PI dose with how far pH actually moved and fold the
+  // result into that reagent's gain. Small doses are skipped: their shift is
+  // mostly probe noise. So is a shift that is missing or far off the
+  // prediction: a stuck or unplugged probe reads no shift at all, and
+  // learning from it would drive the gain, and the doses, to their limits.
+  // Dosing on would still empty the reagent into the tank, so after
+  // PH_MAX_UNANSWERED_DOSES such doses in a row it stops until resetPHFault().
+  void learnGain(float pH) {
+    if (lastDoseMsPerLiter <= 0) {
+      return;
+    }
+    float& gain = lastDoseAcid ? acidGain : baseGain;
+    float shift = lastDoseAcid ? pHBeforeDose - pH : pH - pHBeforeDose;
+    float expected = gain * lastDoseMsPerLiter;
+    if (!isnan(shift) && expected >= PH_MIN_LEARNING_SHIFT) {
+      if (shift < expected / PH_MAX_GAIN_STEP || shift > expected * PH_MAX_GAIN_STEP) {
+        Serial.print(F("pH moved "));
+        Serial.print(shift, 2);
+        Serial.print(F(" against "));
+        Serial.print(expected, 2);
+        Serial.println(F(" expected, check the probe; gain kept"));
+        lastDoseMsPerLiter = 0;
+        if (shift < expected / PH_MAX_GAIN_STEP && ++unansweredDoses >= PH_MAX_UNANSWERED_DOSES) {
+          pHFault = true;
+          phStatus = "fault";
+          Serial.println(F("pH not responding to dosing, dosing stopped until reset"));
+        }
+        return;
+      }
+      unansweredDoses = 0;
+      float observed = shift / lastDoseMsPerLiter;
+      gain += PH_GAIN_LEARNING_RATE * (observed - gain);
+      gain = constrain(gain, PH_INITIAL_GAIN / 8, PH_INITIAL_GAIN * 8);
+      Serial.print(lastDoseAcid ? F("Acid") : F("Base"));
+      Serial.print(F(" gain now "));
+      Serial.print(gain * 1000, 3);
+      Serial.println(F(" pH per s/L"));
+    }
+    lastDoseMsPerLiter = 0;
+  }
+
+  // PI on the error, in pH, turned into pump time through the gain and the
+  // reservoir volume. Anti-windup: the summed error is capped, does not grow
+  // while the correction is at its limit, and restarts when the error changes sign
+  // or pH settles inside the deadband.
+  void sizeDose(float pH) {
+    float error = pH - pHTarget;  // Positive needs acid
+    float volume = snapshot.reservoirVolume;
+    if (isnan(error) || isnan(volume) || volume <= 0) {
+      Serial.println(F("No pH or volume reading, not dosing"));
+      return;
+    }
+    if (fabs(error) <= PH_DEADBAND && pH >= PH_LOWER_LIMIT && pH <= PH_UPPER_LIMIT) {
+      pHIntegral = 0;
+      Serial.println(F("pH within acceptable range"));
+      return;
+    }
+
+    if ((error > 0) != (pHIntegral > 0)) {
+      pHIntegral = 0;
+    }
+    // A large error is corrected in steps, so a gain not yet learned cannot
+    // overshoot far
+    float correction = PH_KP * error + PH_KI * pHIntegral;
+    if (fabs(correction) >= PH_MAX_CORRECTION) {
+      correction = correction > 0 ? PH_MAX_CORRECTION : -PH_MAX_CORRECTION;
+    } else {
+      pHIntegral = constrain(pHIntegral + error, -PH_INTEGRAL_LIMIT, PH_INTEGRAL_LIMIT);
+    }
+    bool acid = correction > 0;
+    float msPerLiter = fabs(correction) / (acid ? acidGain : baseGain);
+
+    // Cap at the bang-bang dose, so a gain learned too low cannot flood the tank
+    uint32_t maxDuration = volume * DOSAGE_RATE * 1000000;
+    uint32_t duration = msPerLiter * volume;
+    if (duration > maxDuration) {
+      duration = maxDuration;
+      msPerLiter = maxDuration / volume;
+    }
+    if (duration < PH_MIN_DOSE_MS) {
+      Serial.println(F("pH correction below the smallest dose"));
+      return;
+    }
+
+    Serial.println(acid ? F("pH too high, activating acid pump") : F("pH too low, activating base pump"));
+    digitalWrite(acid ? Board::acidRelay : Board::baseRelay, RELAY_ON);
+    doseDuration = duration;
+    isDosingAcid = acid;
+    lastDoseAcid = acid;
+    lastDoseMsPerLiter = msPerLiter;
+    pHBeforeDose = pH;
+    isPHAdjusting = true;
+    phStatus = "adjusting";
+
+    Serial.print(F("Dosing for "));
+    Serial.print(duration);
+    Serial.println(F(" ms to correct the error"));
+  }
+
+  SensorSnapshot& snapshot;
+  AccelStepper& stepper;
+
+  uint32_t lastVPDCycleTime = 0;
+  uint32_t mistDayStart = 0;
+  float mistIntegral = 0;
+  uint32_t lastpHCheckTime = 0;
+  uint32_t lastReservoirCheckTime = 0;
+  uint32_t lastRotationTime = 0;
+  uint32_t mixStartTime = 0;
+  uint32_t doseDuration = 0;
+  float pHBeforeDose = 0;
+  float lastDoseMsPerLiter = 0;  // 0 once the last dose has been learned from
+  bool lastDoseAcid = false;
+  uint32_t rotationStartTime = 0;
+  uint32_t rotationMaxLoopMicros = 0;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef DATA_JSON_H
+#define DATA_JSON_H
+
+#include <Arduino.h>
+#include "control_core.h"
+#include "sensor_snapshot.h"
+
+// Allocation-free /data JSON for the web handlers: the body is rendered into
+// fixed buffers instead of through a JSON document.
+
+#define DATA_FIELD_SIZE 16
+#define DATA_KEY_SIZE 24
+#define ZONE_DATA_JSON_SIZE 320  // /data bytes reserved per zone
+
+// One /data value, already rendered as JSON
+struct DataField {
+  const char* key;
+  char value[DATA_FIELD_SIZE];
+};
+
+// Write a float as a JSON number, or null when the sensor read failed
+inline void formatJsonNumber(char* out, size_t size, float value, int decimals) {
+  if (isnan(value)) {
+    snprintf(out, size, "null");
+  } else {
+    snprintf(out, size, "%.*f", decimals, value);
+  }
+}
+
+// The fields each zone publishes, in formatZoneFields() order. The first zone
+// keeps these plain keys; the others are prefixed with the zone name, e.g.
+// "zone2.Temperature".
+#define ZONE_FIELD_COUNT 9
+const char* const zoneFieldKeys[ZONE_FIELD_COUNT] = {
+  "Temperature", "Humidity", "VPD", "pH", "ReservoirVolume", "LightIntensity", "isMisting", "isRotating",
+  "phStatus",
+};
+
+inline void zoneDataKey(char* out, bool firstZone, const char* zoneName, uint8_t field) {
+  if (firstZone) {
+    snprintf(out, DATA_KEY_SIZE, "%s", zoneFieldKeys[field]);
+  } else {
+    snprintf(out, DATA_KEY_SIZE, "zone%s.%s", zoneName, zoneFieldKeys[field]);
+  }
+}
+
+// Render one zone's values into its ZONE_FIELD_COUNT fields. Values are plain
+// numbers/booleans; the page adds the units.
+inline void formatZoneFields(DataField* fields, const SensorSnapshot& snapshot, const ControlState& control) {
+  formatJsonNumber(fields[0].value, DATA_FIELD_SIZE, snapshot.temperature, 1);
+  formatJsonNumber(fields[1].value, DATA_FIELD_SIZE, snapshot.humidity, 1);
+  formatJsonNumber(fields[2].value, DATA_FIELD_SIZE, snapshot.vpd, 2);
+  formatJsonNumber(fields[3].value, DATA_FIELD_SIZE, snapshot.pH, 2);
+  formatJsonNumber(fields[4].value, DATA_FIELD_SIZE, snapshot.reservoirVolume, 1);
+  snprintf(fields[5].value, DATA_FIELD_SIZE, "%d", snapshot.lightIntensity);
+  snprintf(fields[6].value, DATA_FIELD_SIZE, "%s", control.isVPDPumping ? "true" : "false");
+  snprintf(fields[7].value, DATA_FIELD_SIZE, "%s", control.isRotating ? "true" : "false");
+  snprintf(fields[8].value, DATA_FIELD_SIZE, "\"%s\"", control.phStatus);
+}
+
+// Render {"version":..,"timestamp":..,<fields>} into `out`. Returns the
+// length, truncated to size - 1 if the buffer is too small.
+inline size_t writeDataJson(char* out, size_t size, uint32_t version, uint32_t timestamp,
+                            const DataField* fields, int count) {
+  size_t length = snprintf(out, size, "{\"version\":%lu,\"timestamp\":%lu",
+                           (unsigned long)version, (unsigned long)timestamp);
+  for (int i = 0; i < count && length < size; i++) {
+    length += snprintf(out + length, size - length, ",\"%s\":%s", fields[i].key, fields[i].value);
+  }
+  if (length < size) {
+    length += snprintf(out + length, size - length, "}");
+  }
+  return min(length, size - 1);
+}
+
+#endif
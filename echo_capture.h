@@ -0,0 +1,137 @@
+#ifndef ECHO_CAPTURE_H
+#define ECHO_CAPTURE_H
+
+#include <Arduino.h>
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+// Interrupt-driven HC-SR04 ranging, used instead of pulseIn().
+//
+// trigger() sends the 10 us pulse and returns; an edge interrupt on the echo
+// pin timestamps the rising and falling edges. poll() then turns the pulse
+// into a distance without waiting. Pings that time out or fall outside the
+// valid range are dropped, and accepted readings go through a median-of-3 so a
+// single splash does not move the level.
+//
+// Each TrigPin/EchoPin pair gets its own static state and ISR.
+
+#define ECHO_TIMEOUT_US 30000    // HC-SR04 holds echo for ~38 ms when nothing is in range
+#define ECHO_MIN_DISTANCE_CM 2.0 // Closer than this the sensor reports garbage
+#define ECHO_POLL_INTERVAL 5     // ms between poll() calls while a ping is in flight
+
+template <uint8_t TrigPin, uint8_t EchoPin>
+class EchoCapture {
+public:
+  // `maxDistanceCm` is the farthest echo that can be real, e.g. the tank depth
+  static void begin(float maxDistanceCm) {
+    maxDistance = maxDistanceCm;
+    pinMode(TrigPin, OUTPUT);
+    pinMode(EchoPin, INPUT);
+    digitalWrite(TrigPin, LOW);
+    attachInterrupt(digitalPinToInterrupt(EchoPin), onEchoEdge, CHANGE);
+  }
+
+  // Start a ping. Costs ~12 us; the result arrives through poll()
+  static void trigger() {
+    state = ARMED;
+    triggerMicros = micros();
+    digitalWrite(TrigPin, HIGH);
+    delayMicroseconds(10);
+    digitalWrite(TrigPin, LOW);
+  }
+
+  static bool inFlight() {
+    return state == ARMED || state == ECHO_HIGH;
+  }
+
+  // Check on the ping in flight. Returns true when a new filtered distance is
+  // in `distanceCm`; timeouts and out-of-range echoes return false.
+  static bool poll(float& distanceCm) {
+    uint32_t now = micros();
+
+    // Read and reset the state with the ISR held off; an echo ending between
+    // the timeout check and the reset would otherwise be thrown away
+    noInterrupts();
+    State current = state;
+    bool timedOut = (current == ARMED || current == ECHO_HIGH) && now - triggerMicros > ECHO_TIMEOUT_US;
+    if (timedOut || current == DONE) {
+      state = IDLE;
+    }
+    interrupts();
+
+    if (timedOut) {
+      timeouts++;
+    }
+    if (current != DONE) {
+      return false;
+    }
+
+    // The ISR ignores edges until the next trigger(), so pulseMicros is stable here
+    float distance = pulseMicros * 0.034 / 2;
+    if (distance < ECHO_MIN_DISTANCE_CM || distance > maxDistance) {
+      rejected++;
+      return false;
+    }
+
+    history[historyIndex] = distance;
+    historyIndex = (historyIndex + 1) % 3;
+    if (historyCount < 3) {
+      historyCount++;
+    }
+    distanceCm = median();
+    return true;
+  }
+
+  static uint32_t timeouts;
+  static uint32_t rejected;
+
+private:
+  enum State : uint8_t { IDLE, ARMED, ECHO_HIGH, DONE };
+
+  static void IRAM_ATTR onEchoEdge() {
+    uint32_t now = micros();
+    if (digitalRead(EchoPin) == HIGH) {
+      if (state == ARMED) {
+        riseMicros = now;
+        state = ECHO_HIGH;
+      }
+    } else if (state == ECHO_HIGH) {
+      pulseMicros = now - riseMicros;
+      state = DONE;
+    }
+  }
+
+  static float median() {
+    if (historyCount < 3) {
+      return history[(historyIndex + 2) % 3];  // Latest until the window fills
+    }
+    float a = history[0], b = history[1], c = history[2];
+    if (a > b) { float t = a; a = b; b = t; }
+    if (b > c) { b = c; }
+    return a > b ? a : b;
+  }
+
+  static volatile State state;
+  static volatile uint32_t riseMicros;
+  static volatile uint32_t pulseMicros;
+  static uint32_t triggerMicros;
+  static float maxDistance;
+  static float history[3];
+  static uint8_t historyIndex;
+  static uint8_t historyCount;
+};
+
+template <uint8_t T, uint8_t E> volatile typename EchoCapture<T, E>::State EchoCapture<T, E>::state = EchoCapture<T, E>::IDLE;
+template <uint8_t T, uint8_t E> volatile uint32_t EchoCapture<T, E>::riseMicros = 0;
+template <uint8_t T, uint8_t E> volatile uint32_t EchoCapture<T, E>::pulseMicros = 0;
+template <uint8_t T, uint8_t E> uint32_t EchoCapture<T, E>::triggerMicros = 0;
+template <uint8_t T, uint8_t E> float EchoCapture<T, E>::maxDistance = 400.0;
+template <uint8_t T, uint8_t E> float EchoCapture<T, E>::history[3] = {0, 0, 0};
+template <uint8_t T, uint8_t E> uint8_t EchoCapture<T, E>::historyIndex = 0;
+template <uint8_t T, uint8_t E> uint8_t EchoCapture<T, E>::historyCount = 0;
+template <uint8_t T, uint8_t E> uint32_t EchoCapture<T, E>::timeouts = 0;
+template <uint8_t T, uint8_t E> uint32_t EchoCapture<T, E>::rejected = 0;
+
+#endif
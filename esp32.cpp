@@ -4,59 +4,52 @@
 #include "Adafruit_SHT31.h"
 #include <WiFi.h>
 #include <WebServer.h>
-#include <ArduinoJson.h>
-
-// Pin Definitions for ESP32-S3
-#define PH_PIN 1          // ADC1_CH0
-#define VPD_PUMP_RELAY 2  
-#define ACID_PUMP_RELAY 3 
-#define BASE_PUMP_RELAY 4 
-#define MIX_PUMP_RELAY 5  
-#define TRIG_PIN 6        
-#define ECHO_PIN 7        
-#define LDR_PIN 2        // Changed to ADC1_CH1 for analog reading
-#define STEPPER_STEP_PIN 9 
-#define STEPPER_DIR_PIN 10  
-
-// Constants (unchanged)
-#define VPD_PUMP_DURATION 5000
-#define MIX_PUMP_DURATION 1000
-#define PH_CHECK_INTERVAL 30000
-#define PH_WAIT_INTERVAL 18000
-#define PH_LOWER_LIMIT 5.5
-#define PH_UPPER_LIMIT 6.5
-#define DOSAGE_RATE 0.00025
-#define RESERVOIR_RADIUS 20.0
-#define RESERVOIR_HEIGHT 35.0
-#define RESERVOIR_CHECK_INTERVAL 3600
-#define ROTATION_INTERVAL 5000
-#define STEPS_PER_REVOLUTION 200
-#define STEPS_90_DEGREES (STEPS_PER_REVOLUTION / 4)
+#include <WebSocketsServer.h>
+#include "job_scheduler.h"
+#include "sensor_snapshot.h"
+#include "echo_capture.h"
+#include "adc_filter.h"
+#include "history.h"
+#include "data_json.h"
+#include "control_command.h"
+#include "loop_metrics.h"
+#include "control_core.h"
+#include "zone.h"
+#include "esp32_zones.h"
+#include "esp32_dashboard_html.h"
+
+// Constants
+#define ADC_CONVERSIONS_PER_PIN 32  // Averaged by the ADC driver into one frame value
+#define ADC_SAMPLE_FREQ_HZ 1000     // Per zone
+#define ADC_DRAIN_INTERVAL 50
+#define HTTP_POLL_INTERVAL 2
+#define WEB_TASK_CORE 0          // Same core as the WiFi stack; loop() runs on core 1
+#define WEB_TASK_STACK 8192
+#define WEB_TASK_PRIORITY 1
+#define COMMAND_QUEUE_LENGTH 8
+#define HISTORY_INTERVAL 1000
+#define HISTORY_PSRAM_BYTES (384 * 1024)  // ~15 h at 1 Hz, shared evenly by the zones
+#define HISTORY_HEAP_BYTES (32 * 1024)    // ~1 h when the module has no PSRAM
+#define HISTORY_CHUNK_SAMPLES 32
+#define SCHEDULE_REPORT_INTERVAL 60000
 
 // Global variables
-Adafruit_SHT31 sht31 = Adafruit_SHT31();
-AccelStepper stepper(AccelStepper::DRIVER, STEPPER_STEP_PIN, STEPPER_DIR_PIN);
-
-unsigned long lastVPDCycleTime = 0;
-unsigned long vpdCycleInterval = 1200;
-unsigned long lastpHCheckTime = 0;
-unsigned long lastReservoirCheckTime = 0;
-unsigned long lastRotationTime = 0;
-
-bool isVPDPumping = false;
-bool isPHAdjusting = false;
-bool isPHWaiting = false;
-
-long ph_pump_duration = 0;
-
-float temperature = 0.0;
-float humidity = 0.0;
-float vpd = 0.0;
-float pH = 0.0;
-float waterLevel = 0.0;
-float reservoirVolume = 0.0;
-int lightIntensity = 0;  // Changed from bool to int
-float PH_TARGET = 6.0;
+JobScheduler scheduler;
+
+// Each zone is one reservoir and tower with its own sensors, setpoints and
+// control state. Sensor values are only read by sampleSensors(); everything
+// else uses the zones' snapshots. The S3 has free pins for two zones;
+// a third needs an I/O expander for its relays and stepper.
+BoardZone<Zone1Board> zone1("1");
+BoardZone<Zone2Board> zone2("2");
+Zone* const zones[] = {&zone1, &zone2};
+constexpr uint8_t ZONE_COUNT = sizeof(zones) / sizeof(zones[0]);
+
+// pH and LDR are sampled in the background by the continuous (DMA) ADC; each
+// frame is handed to the zones' filters and the sampler reads the filtered value
+#define ADC_PIN_COUNT (2 * ZONE_COUNT)
+volatile bool adcFrameReady = false;
+bool adcContinuous = false;
 
 // Replace the existing WiFi credentials with AP settings
 const char* ap_ssid = "Aeroponics_Control";     // Name of the WiFi network to create
@@ -67,65 +60,108 @@ IPAddress subnet(255,255,255,0);               // Subnet mask
 
 // Create WebServer object after your existing global variables
 WebServer server(80);
-
-int LIGHT_THRESHOLD = 2000;  // Initial value, can be modified at runtime
-
-// Add these at the top with other global variables
-unsigned long lastDataUpdate = 0;
-const unsigned long DATA_UPDATE_INTERVAL = 1000; // Update data every second
-
-// Add these default values with the other global variables at the top
-const float DEFAULT_TEMPERATURE = 25.0;
-const float DEFAULT_HUMIDITY = 60.0;
-
-// Add these global variables for tracking states
-bool isMistingActive = false;
-bool isRotating = false;
-String phStatus = "stable"; // Can be "stable", "adjusting", or "completed"
+WebSocketsServer webSocket(81);  // Live push channel for the dashboard
+
+// The web server runs in its own task on core 0. It reads the published data
+// below under dataMutex and sends setpoint changes back through commandQueue;
+// it never touches the snapshots, the control state or the relays directly.
+TaskHandle_t webTaskHandle = NULL;
+SemaphoreHandle_t dataMutex = NULL;
+QueueHandle_t commandQueue = NULL;
+
+// /data body, re-serialized by publishData() whenever a sensor or state changes
+// so requests just copy these bytes out. Written on the control loop and read
+// by the web task, so both sides hold dataMutex.
+#define DATA_JSON_SIZE (ZONE_DATA_JSON_SIZE * ZONE_COUNT)
+char dataJson[DATA_JSON_SIZE];
+size_t dataJsonLength = 0;
+volatile uint32_t dataVersion = 0;
+uint32_t bootId = 0;  // Part of the /data ETag so versions from before a reboot never match
+
+// The same values as already-rendered JSON, one per field, so WebSocket
+// clients can be sent only the fields that changed since the last push.
+// Zone 1 keeps the plain keys the dashboard reads; the others are prefixed
+// with the zone, e.g. "zone2.Temperature". Keys are filled in by setup().
+#define DATA_FIELD_COUNT (ZONE_FIELD_COUNT * ZONE_COUNT)
+char dataKeys[DATA_FIELD_COUNT][DATA_KEY_SIZE];
+DataField dataFields[DATA_FIELD_COUNT];
+char pushedFields[DATA_FIELD_COUNT][DATA_FIELD_SIZE];
+
+// 1 Hz record of each zone's snapshot behind /history, indexed like zones.
+// Appended on the control loop, read by the web task a chunk at a time, both
+// under historyMutex.
+SensorHistory history[ZONE_COUNT];
+SemaphoreHandle_t historyMutex = NULL;
+uint32_t pushedVersion = 0;
+
+// Timings behind /metrics, from the CPU cycle counter. loop() records its
+// stages and jobs on core 1 and the web task records requests on core 0; the
+// scrape copies them out under metricsLock, a spinlock since both cores write.
+enum LoopStage : uint8_t { STAGE_ROTATION, STAGE_JOBS, STAGE_COMMANDS, STAGE_COUNT };
+const char* const stageNames[STAGE_COUNT] = {"rotation", "jobs", "commands"};
+enum HttpRoute : uint8_t { ROUTE_ROOT, ROUTE_DATA, ROUTE_HISTORY, ROUTE_CONTROL, ROUTE_METRICS, ROUTE_COUNT };
+const char* const routeNames[ROUTE_COUNT] = {"/", "/data", "/history", "/control", "/metrics"};
+TimingStat loopTime;
+TimingStat stageTime[STAGE_COUNT];
+TimingStat jobTime[SCHEDULER_MAX_JOBS];
+TimingStat httpTime[ROUTE_COUNT];
+const char* jobNames[SCHEDULER_MAX_JOBS];  // Copied once in setup(); the scheduler reorders its table
+portMUX_TYPE metricsLock = portMUX_INITIALIZER_UNLOCKED;
+float mistDuty[ZONE_COUNT];  // Misting figures copied out of the control state each pass
+MistUsage mistToday[ZONE_COUNT];
+MistUsage mistYesterday[ZONE_COUNT];
+uint32_t cpuMHz = 240;
 
 // Function declarations
 void handleRoot();
 void handleData();
+void handleHistory();
+void handleMetrics();
+void timeRequest(HttpRoute route, void (*handler)());
+void onJobRun(uint8_t id, uint32_t runMicros);
+uint32_t elapsedMicros(uint32_t startCycles);
+void publishData();
+void pushDataDelta();
+void onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length);
 void handleControl();
 void checkNewClients();
-void handleVPDControl(unsigned long currentTime);
-void handlePHControl(unsigned long currentTime);
-void checkReservoirVolume(unsigned long currentTime);
-void checkLightAndRotate(unsigned long currentTime);
-void checkAndAdjustPH(unsigned long currentTime);
-float readpH();
-float calculateVPD(float temperature, float humidity);
-void updateVPDCycleInterval(float vpd);
-float measureWaterLevel();
-float calculateReservoirVolume(float waterLevel);
+void webTask(void* parameter);
+void applyCommand(const ControlCommand& command);
+uint32_t runZones(uint32_t (Zone::*job)(uint32_t), uint32_t currentTime);
+void serviceRotations();
+bool anyRotating();
+uint32_t sampleSensors(uint32_t currentTime);
+uint32_t drainAdc(uint32_t currentTime);
+void onAdcFrame();
+uint32_t reportSchedule(uint32_t currentTime);
+uint32_t recordHistory(uint32_t currentTime);
+uint32_t uptimeSeconds();
 
 void setup() {
   Serial.begin(115200);
-  Wire.begin(41, 42);  // ESP32-S3 default I2C pins: SDA=41, SCL=42
-  
-  pinMode(VPD_PUMP_RELAY, OUTPUT);
-  pinMode(ACID_PUMP_RELAY, OUTPUT);
-  pinMode(BASE_PUMP_RELAY, OUTPUT);
-  pinMode(MIX_PUMP_RELAY, OUTPUT);
-  pinMode(TRIG_PIN, OUTPUT);
-  pinMode(ECHO_PIN, INPUT);
-  // Remove this line since analog pins don't need pinMode
-  // pinMode(LDR_PIN, INPUT);  
+  Wire.begin(Zone1Board::sdaPin, Zone1Board::sclPin);
   
-  digitalWrite(VPD_PUMP_RELAY, HIGH);
-  digitalWrite(ACID_PUMP_RELAY, HIGH);
-  digitalWrite(BASE_PUMP_RELAY, HIGH);
-  digitalWrite(MIX_PUMP_RELAY, HIGH);
-  
-  if (!sht31.begin(0x44)) {
-    Serial.println("Warning: Couldn't find SHT31 sensor. Will continue with default values.");
+  for (Zone* zone : zones) {
+    zone->begin();
   }
-  
-  stepper.setMaxSpeed(1000);
-  stepper.setAcceleration(500);
 
   // ESP32 ADC setup
   analogReadResolution(12); // ESP32 has 12-bit ADC
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  uint8_t adcPins[ADC_PIN_COUNT];
+  for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+    adcPins[2 * i] = zones[i]->phPin();
+    adcPins[2 * i + 1] = zones[i]->ldrPin();
+  }
+  analogContinuousSetWidth(12);
+  analogContinuousSetAtten(ADC_11db);
+  adcContinuous = analogContinuous(adcPins, ADC_PIN_COUNT, ADC_CONVERSIONS_PER_PIN,
+                                   ADC_SAMPLE_FREQ_HZ * ZONE_COUNT, onAdcFrame) &&
+                  analogContinuousStart();
+#endif
+  if (!adcContinuous) {
+    Serial.println("Warning: continuous ADC unavailable, falling back to analogRead()");
+  }
 
   // Replace the existing WiFi setup with this:
   WiFi.mode(WIFI_AP);                          // Set ESP32 as an Access Point
@@ -140,504 +176,653 @@ void setup() {
   Serial.print("Password: ");
   Serial.println(ap_password);
 
-  server.on("/", handleRoot);
-  server.on("/data", handleData);
-  server.on("/control", handleControl);
+  server.on("/", [] { timeRequest(ROUTE_ROOT, handleRoot); });
+  server.on("/data", [] { timeRequest(ROUTE_DATA, handleData); });
+  server.on("/history", [] { timeRequest(ROUTE_HISTORY, handleHistory); });
+  server.on("/control", [] { timeRequest(ROUTE_CONTROL, handleControl); });
+  server.on("/metrics", [] { timeRequest(ROUTE_METRICS, handleMetrics); });
+  bootId = esp_random();
+  const char* headerKeys[] = {"If-None-Match"};
+  server.collectHeaders(headerKeys, 1);
   server.begin();
   Serial.println("HTTP server started");
+
+  webSocket.begin();
+  webSocket.onEvent(onWebSocketEvent);
+
+  dataMutex = xSemaphoreCreateMutex();
+  historyMutex = xSemaphoreCreateMutex();
+  size_t historyBytes = HISTORY_PSRAM_BYTES;
+  uint8_t* historyBuffer = psramFound() ? (uint8_t*)ps_malloc(historyBytes) : NULL;
+  if (historyBuffer == NULL) {
+    historyBytes = HISTORY_HEAP_BYTES;
+    historyBuffer = (uint8_t*)malloc(historyBytes);
+  }
+  size_t zoneHistoryBytes = historyBytes / ZONE_COUNT;
+  for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+    history[i].begin(historyBuffer != NULL ? historyBuffer + i * zoneHistoryBytes : NULL, zoneHistoryBytes);
+  }
+  Serial.printf("History buffer: %u bytes per zone\n", (unsigned)history[0].capacityBytes());
+  commandQueue = xQueueCreate(COMMAND_QUEUE_LENGTH, sizeof(ControlCommand));
+  for (uint8_t i = 0; i < DATA_FIELD_COUNT; i++) {
+    const Zone* zone = zones[i / ZONE_FIELD_COUNT];
+    zoneDataKey(dataKeys[i], zone == zones[0], zone->name, i % ZONE_FIELD_COUNT);
+    dataFields[i].key = dataKeys[i];
+  }
+  for (Zone* zone : zones) {
+    zone->control.onChange = publishData;
+  }
+  publishData();
+
+  // Every periodic job lives here; each one returns the ms until it is next
+  // due. The control jobs run every zone in one pass, so the job table does
+  // not grow with the zone count.
+  scheduler.add("adc", drainAdc);
+  scheduler.add("sensors", sampleSensors);
+  scheduler.add("vpd", [](uint32_t t) { return runZones(&Zone::runVPD, t); });
+  scheduler.add("ph", [](uint32_t t) { return runZones(&Zone::runPH, t); });
+  scheduler.add("reservoir", [](uint32_t t) { return runZones(&Zone::runReservoir, t); });
+  scheduler.add("rotation", [](uint32_t t) { return runZones(&Zone::runRotation, t); });
+  scheduler.add("history", recordHistory, HISTORY_INTERVAL);
+  scheduler.add("report", reportSchedule, SCHEDULE_REPORT_INTERVAL);
+  for (uint8_t id = 0; id < scheduler.jobCount(); id++) {
+    jobNames[id] = scheduler.jobName(id);
+  }
+  scheduler.observe(onJobRun);
+  cpuMHz = ESP.getCpuFreqMHz();
+
+  xTaskCreatePinnedToCore(webTask, "web", WEB_TASK_STACK, NULL, WEB_TASK_PRIORITY, &webTaskHandle, WEB_TASK_CORE);
 }
 
 void loop() {
-  unsigned long currentTime = millis();
-  
-  server.handleClient();
-  checkNewClients();  // Add this line to monitor connections
-
-  // Read sensor data
-  temperature = sht31.readTemperature();
-  humidity = sht31.readHumidity();
-  vpd = calculateVPD(temperature, humidity);
-  pH = readpH();
-  waterLevel = measureWaterLevel();
-  reservoirVolume = calculateReservoirVolume(waterLevel);
-  lightIntensity = analogRead(LDR_PIN);  // Changed to analogRead
-
-  handleVPDControl(currentTime);
-  handlePHControl(currentTime);
-  checkReservoirVolume(currentTime);
-  checkLightAndRotate(currentTime);
-  
-  stepper.run();
+  uint32_t loopStart = ESP.getCycleCount();
+
+  serviceRotations();
+  uint32_t rotationMicros = elapsedMicros(loopStart);
+  uint32_t stageStart = ESP.getCycleCount();
+  uint32_t idleMs = scheduler.runDue();
+  uint32_t jobsMicros = elapsedMicros(stageStart);
+  stageStart = ESP.getCycleCount();
+  serviceRotations();
+  rotationMicros += elapsedMicros(stageStart);
+  uint32_t loopMicros = elapsedMicros(loopStart);
+  for (Zone* zone : zones) {
+    zone->recordLoopPass(loopMicros);
+  }
+
+  // Sleep until the next deadline, waking early for a command from the web
+  // task. The stepper needs run() every step interval, so never block while
+  // it is moving. Only the time spent applying commands counts as busy.
+  ControlCommand command;
+  TickType_t wait = anyRotating() ? 0 : pdMS_TO_TICKS(idleMs);
+  uint32_t commandMicros = 0;
+  while (xQueueReceive(commandQueue, &command, wait) == pdTRUE) {
+    stageStart = ESP.getCycleCount();
+    applyCommand(command);
+    commandMicros += elapsedMicros(stageStart);
+    wait = 0;
+  }
+
+  portENTER_CRITICAL(&metricsLock);
+  loopTime.record(loopMicros + commandMicros);
+  stageTime[STAGE_ROTATION].record(rotationMicros);
+  stageTime[STAGE_JOBS].record(jobsMicros);
+  stageTime[STAGE_COMMANDS].record(commandMicros);
+  for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+    mistDuty[i] = zones[i]->control.mistDuty;
+    mistToday[i] = zones[i]->control.mistToday;
+    mistYesterday[i] = zones[i]->control.mistYesterday;
+  }
+  portEXIT_CRITICAL(&metricsLock);
 }
 
-// Modified pH reading for ESP32's 12-bit ADC
-float readpH() {
-  int sensorValue = analogRead(PH_PIN);
-  // ESP32 ADC is 12-bit (0-4095)
-  return map(sensorValue, 0, 4095, 0, 14);
+// Run one control job for every zone; it is next due when the first zone is
+uint32_t runZones(uint32_t (Zone::*job)(uint32_t), uint32_t currentTime) {
+  uint32_t next = UINT32_MAX;
+  for (Zone* zone : zones) {
+    next = min(next, (zone->*job)(currentTime));
+  }
+  return next;
 }
 
-// The rest of the functions remain the same as they don't need ESP-specific modifications
-// Just removing yield() calls as they're not needed for ESP32
-
-void checkLightAndRotate(unsigned long currentTime) {
-  if (currentTime - lastRotationTime >= ROTATION_INTERVAL) {
-    lastRotationTime = currentTime;
-    
-    int lightLevel = analogRead(LDR_PIN);
-    Serial.printf("Light intensity: %d\n", lightLevel);
-
-    if (lightLevel > LIGHT_THRESHOLD) {
-      isRotating = true;
-      stepper.moveTo(stepper.currentPosition() + STEPS_90_DEGREES);
-      while (stepper.distanceToGo() != 0) {
-        stepper.run();
-      }
-      isRotating = false;
-    } else {
-      Serial.println("Insufficient light, not rotating");
-    }
+// Each stepper needs run() every step interval, so every zone is serviced
+// on every pass
+void serviceRotations() {
+  for (Zone* zone : zones) {
+    zone->serviceRotation();
   }
 }
 
-// Include all other functions here (handleVPDControl, handlePHControl, etc.)
-// They remain the same as in your original code, just remove the yield() calls 
-
-void handleVPDControl(unsigned long currentTime) {
-  if (currentTime - lastVPDCycleTime >= vpdCycleInterval) {
-    lastVPDCycleTime = currentTime;
-    
-    float humidity = sht31.readHumidity();
-    float temperature = sht31.readTemperature();
-
-    // Use default values if readings are invalid
-    if (isnan(humidity) || isnan(temperature)) {
-      humidity = DEFAULT_HUMIDITY;
-      temperature = DEFAULT_TEMPERATURE;
-      Serial.println("Warning: Using default temperature and humidity values");
+bool anyRotating() {
+  for (Zone* zone : zones) {
+    if (zone->control.isRotating) {
+      return true;
     }
+  }
+  return false;
+}
 
-    float vpd = calculateVPD(temperature, humidity);
-    updateVPDCycleInterval(vpd);
-    
-    Serial.printf("Humidity: %.1f%%, Temperature: %.1f°C, VPD: %.2f kPa\n", 
-                 humidity, temperature, vpd);
+// Microseconds since `startCycles` on this core's cycle counter. It wraps
+// every ~17 s at 240 MHz, far longer than anything timed with it.
+uint32_t elapsedMicros(uint32_t startCycles) {
+  return (ESP.getCycleCount() - startCycles) / cpuMHz;
+}
 
-    digitalWrite(VPD_PUMP_RELAY, LOW);
-    isVPDPumping = true;
-    Serial.println("VPD Pump activated");
-  }
+// Scheduler observer: per-job run time, so a slow pass can be pinned on a job
+void onJobRun(uint8_t id, uint32_t runMicros) {
+  portENTER_CRITICAL(&metricsLock);
+  jobTime[id].record(runMicros);
+  portEXIT_CRITICAL(&metricsLock);
+}
+
+// Every route goes through here so /metrics has per-path request latency
+void timeRequest(HttpRoute route, void (*handler)()) {
+  uint32_t start = ESP.getCycleCount();
+  handler();
+  uint32_t micros = elapsedMicros(start);
+  portENTER_CRITICAL(&metricsLock);
+  httpTime[route].record(micros);
+  portEXIT_CRITICAL(&metricsLock);
+}
 
-  if (isVPDPumping && currentTime - lastVPDCycleTime >= VPD_PUMP_DURATION) {
-    digitalWrite(VPD_PUMP_RELAY, HIGH);
-    isVPDPumping = false;
-    Serial.println("VPD Pump deactivated");
+// Web task, pinned to core 0. Slow or stalled clients only hold up this loop;
+// the control jobs on core 1 keep their deadlines.
+void webTask(void* parameter) {
+  for (;;) {
+    server.handleClient();
+    webSocket.loop();
+    if (pushedVersion != dataVersion) {
+      pushDataDelta();
+    }
+    checkNewClients();  // Add this line to monitor connections
+    vTaskDelay(pdMS_TO_TICKS(HTTP_POLL_INTERVAL));
   }
 }
 
-void handlePHControl(unsigned long currentTime) {
-  if (!isPHAdjusting && !isPHWaiting && currentTime - lastpHCheckTime >= PH_CHECK_INTERVAL) {
-    phStatus = "stable";
-    checkAndAdjustPH(currentTime);
+// Setpoint changes queued by handleControl(), applied between control jobs
+void applyCommand(const ControlCommand& command) {
+  ControlState& control = zones[command.zone]->control;
+  const char* zone = zones[command.zone]->name;
+  switch (command.type) {
+    case SET_LIGHT_THRESHOLD:
+      control.lightThreshold = (int)command.value;
+      Serial.printf("Zone %s light threshold set to: %d\n", zone, control.lightThreshold);
+      break;
+    case SET_PH_TARGET:
+      control.pHTarget = command.value;
+      Serial.printf("Zone %s pH target set to: %.2f\n", zone, control.pHTarget);
+      break;
+    case SET_VPD_LOW:
+      control.vpdLow = min(command.value, control.vpdHigh);
+      Serial.printf("Zone %s VPD band set to: %.2f-%.2f kPa\n", zone, control.vpdLow, control.vpdHigh);
+      break;
+    case SET_VPD_HIGH:
+      control.vpdHigh = max(command.value, control.vpdLow);
+      Serial.printf("Zone %s VPD band set to: %.2f-%.2f kPa\n", zone, control.vpdLow, control.vpdHigh);
+      break;
+    case RESET_PH_FAULT:
+      control.resetPHFault();
+      Serial.printf("Zone %s pH fault reset, dosing resumed\n", zone);
+      break;
   }
+}
 
-  if (isPHWaiting && currentTime - lastpHCheckTime >= PH_WAIT_INTERVAL) {
-    isPHWaiting = false;
-    checkAndAdjustPH(currentTime);
+// Read each zone's sensors at their own rates and publish the results. An
+// SHT31 read takes tens of ms, so at most one happens per pass, taken by the
+// zones in turn: the longest pass stays one read however many zones there
+// are. None happens while a tray is rotating, since it would starve the stepper.
+uint32_t sampleSensors(uint32_t currentTime) {
+  static uint8_t climateTurn = 0;  // Zone whose read goes first next pass
+  bool climateAllowed = !anyRotating();
+  bool updated = false;
+  uint32_t next = UINT32_MAX;
+
+  uint8_t first = climateTurn;
+  for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+    uint8_t index = (first + i) % ZONE_COUNT;
+    bool climateRead;
+    if (zones[index]->sample(currentTime, climateAllowed, climateRead)) {
+      updated = true;
+    }
+    if (climateRead) {
+      climateAllowed = false;
+      climateTurn = (index + 1) % ZONE_COUNT;
+    }
+    next = min(next, zones[index]->msUntilDue(currentTime));
   }
 
-  if (isPHAdjusting && currentTime - lastpHCheckTime >= ph_pump_duration) {
-    digitalWrite(ACID_PUMP_RELAY, HIGH);
-    digitalWrite(BASE_PUMP_RELAY, HIGH);
-    digitalWrite(MIX_PUMP_RELAY, LOW);
-    
-    delay(MIX_PUMP_DURATION);
-    
-    digitalWrite(MIX_PUMP_RELAY, HIGH);
-    isPHAdjusting = false;
-    isPHWaiting = true;
-    Serial.println("pH adjustment cycle completed, waiting before rechecking");
+  if (updated) {
+    publishData();
   }
-}
 
-void checkReservoirVolume(unsigned long currentTime) {
-  if (currentTime - lastReservoirCheckTime >= RESERVOIR_CHECK_INTERVAL) {
-    lastReservoirCheckTime = currentTime;
-    
-    float waterLevel = measureWaterLevel();
-    float volume = calculateReservoirVolume(waterLevel);
-    
-    Serial.printf("Volume: %.1f liters\n", volume);
-    ph_pump_duration = volume * DOSAGE_RATE * 1000000; // Convert to ms
+  // Anything still due was held back: by a rotation, look again shortly; by
+  // another zone's read, on the next pass
+  if (next > 0) {
+    return next;
   }
+  return anyRotating() ? 100 : 1;
 }
 
-float calculateVPD(float temperature, float humidity) {
-  float svp = 0.6108 * exp(17.27 * temperature / (temperature + 237.3)); 
-  float avp = (humidity / 100.0) * svp;
-  return svp - avp;
+uint32_t reportSchedule(uint32_t currentTime) {
+  scheduler.print(Serial);
+  Serial.printf("Web task stack headroom: %u bytes\n", (unsigned)uxTaskGetStackHighWaterMark(webTaskHandle));
+  return SCHEDULE_REPORT_INTERVAL;
 }
 
-void updateVPDCycleInterval(float vpd) {
-  vpdCycleInterval = (vpd > 1.5) ? 6000 : (vpd < 0.8) ? 18000 : 12000;
-  Serial.printf("New VPD cycle interval: %d seconds\n", vpdCycleInterval / 1000);
+// Seconds since boot from the 64-bit esp_timer, so history times never wrap
+uint32_t uptimeSeconds() {
+  return (uint32_t)(esp_timer_get_time() / 1000000);
 }
 
-float measureWaterLevel() {
-  digitalWrite(TRIG_PIN, LOW);
-  delayMicroseconds(2);
-  digitalWrite(TRIG_PIN, HIGH);
-  delayMicroseconds(10);
-  digitalWrite(TRIG_PIN, LOW);
-  
-  long duration = pulseIn(ECHO_PIN, HIGH);
-  return RESERVOIR_HEIGHT - (duration * 0.034 / 2);
+uint32_t recordHistory(uint32_t currentTime) {
+  uint32_t time = uptimeSeconds();
+  for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+    const SensorSnapshot& snapshot = zones[i]->snapshot;
+    HistorySample sample;
+    sample.time = time;
+    sample.temperature = snapshot.temperature;
+    sample.humidity = snapshot.humidity;
+    sample.vpd = snapshot.vpd;
+    sample.pH = snapshot.pH;
+    sample.reservoirVolume = snapshot.reservoirVolume;
+    sample.lightIntensity = snapshot.lightIntensity;
+
+    xSemaphoreTake(historyMutex, portMAX_DELAY);
+    history[i].append(sample);
+    xSemaphoreGive(historyMutex);
+  }
+  return HISTORY_INTERVAL;
 }
 
-float calculateReservoirVolume(float waterLevel) {
-  return PI * RESERVOIR_RADIUS * RESERVOIR_RADIUS * waterLevel / 1000.0;
+// Called from the ADC driver's ISR when a frame of conversions is ready
+void ARDUINO_ISR_ATTR onAdcFrame() {
+  adcFrameReady = true;
 }
 
-void checkAndAdjustPH(unsigned long currentTime) {
-  lastpHCheckTime = currentTime;
-  float pH = readpH();
-  Serial.printf("Current pH: %.2f\n", pH);
+// Move the latest ADC frame into the zones' filters. Never waits on the ADC:
+// if no frame is ready yet the filters just keep their previous samples.
+uint32_t drainAdc(uint32_t currentTime) {
+  // Without it the zones' samplers read the pins themselves
+  if (!adcContinuous) {
+    return ADC_DRAIN_INTERVAL;
+  }
 
-  if (pH < PH_LOWER_LIMIT || pH > PH_UPPER_LIMIT) {
-    if (pH < PH_TARGET) {
-      Serial.println("pH too low, activating base pump");
-      digitalWrite(BASE_PUMP_RELAY, LOW);
-    } else {
-      Serial.println("pH too high, activating acid pump");
-      digitalWrite(ACID_PUMP_RELAY, LOW);
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  adc_continuous_data_t* frame = NULL;
+  if (adcFrameReady) {
+    adcFrameReady = false;
+    if (analogContinuousRead(&frame, 0)) {
+      for (int i = 0; i < ADC_PIN_COUNT; i++) {
+        for (Zone* zone : zones) {
+          zone->pushAdc(frame[i].pin, frame[i].avg_read_raw);
+        }
+      }
     }
-    isPHAdjusting = true;
-    
-    Serial.printf("Dosing for %ld ms based on current reservoir volume\n", ph_pump_duration);
-  } else {
-    Serial.println("pH within acceptable range");
   }
+#endif
+  return ADC_DRAIN_INTERVAL;
 }
 
-// Modify handleRoot() with a modern, cleaner interface
+// Serve the dashboard straight from flash. It is minified and gzipped at build
+// time (tools/embed_html.py) and carries a content-hash ETag, so browsers
+// revalidate cheaply and pick up a new page after a firmware update.
 void handleRoot() {
-  server.sendHeader("Cache-Control", "max-age=31536000");
-  
-  String html = R"rawliteral(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>Aeroponic Control System</title>
-    <link rel="stylesheet" href="https://fonts.googleapis.com/css2?family=Inter:wght@400;500;600&display=swap">
-    <style>
-        :root {
-            --primary-gradient-start: #84fab0;
-            --primary-gradient-end: #8fd3f4;
-            --card-background: rgba(255, 255, 255, 0.9);
-            --text-primary: #2c3e50;
-            --text-secondary: #5a7a94;
-            --success-color: #059669;
-            --warning-color: #d97706;
-            --shadow-color: rgba(0, 0, 0, 0.1);
-        }
-
-        body {
-            font-family: Arial, sans-serif;
-            background: linear-gradient(120deg, var(--primary-gradient-start) 0%, var(--primary-gradient-end) 100%);
-            margin: 0;
-            padding: 20px;
-            color: var(--text-primary);
-            min-height: 100vh;
-        }
-
-        .container {
-            max-width: 1200px;
-            margin: 2rem auto;
-            padding: 0 1rem;
-        }
+  server.sendHeader("ETag", ESP32_DASHBOARD_ETAG);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (server.header("If-None-Match") == ESP32_DASHBOARD_ETAG) {
+    server.send(304);
+    return;
+  }
 
-        .header {
-            text-align: center;
-            margin-bottom: 2rem;
-        }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (PGM_P)ESP32_DASHBOARD_GZ, ESP32_DASHBOARD_GZ_LEN);
+}
 
-        .header h1 {
-            font-size: 2.25rem;
-            font-weight: 600;
-            color: var(--text-primary);
-            margin-bottom: 0.5rem;
-        }
+// Serialize every zone's snapshot and control state into dataFields and
+// dataJson. The timestamp is that of the newest sample in any zone.
+void publishData() {
+  xSemaphoreTake(dataMutex, portMAX_DELAY);
+  uint32_t timestamp = zones[0]->snapshot.timestamp;
+  for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+    const SensorSnapshot& snapshot = zones[i]->snapshot;
+    formatZoneFields(dataFields + i * ZONE_FIELD_COUNT, snapshot, zones[i]->control);
+    if ((int32_t)(snapshot.timestamp - timestamp) > 0) {
+      timestamp = snapshot.timestamp;
+    }
+  }
 
-        .header p {
-            color: var(--text-secondary);
-        }
+  dataVersion++;
+  dataJsonLength = writeDataJson(dataJson, DATA_JSON_SIZE, dataVersion, timestamp,
+                                 dataFields, DATA_FIELD_COUNT);
+  xSemaphoreGive(dataMutex);
+}
 
-        .dashboard {
-            display: grid;
-            grid-template-columns: repeat(auto-fit, minmax(280px, 1fr));
-            gap: 1.5rem;
-            margin-bottom: 2rem;
-        }
+// Broadcast the fields that changed since the last push. Values are compared
+// as rendered, so noise below the displayed precision costs no airtime.
+void pushDataDelta() {
+  char delta[DATA_JSON_SIZE];
+  bool changed = false;
+
+  xSemaphoreTake(dataMutex, portMAX_DELAY);
+  size_t length = snprintf(delta, sizeof(delta), "{\"version\":%lu", (unsigned long)dataVersion);
+  for (int i = 0; i < DATA_FIELD_COUNT && length < sizeof(delta); i++) {
+    if (strcmp(dataFields[i].value, pushedFields[i]) != 0) {
+      length += snprintf(delta + length, sizeof(delta) - length, ",\"%s\":%s",
+                         dataFields[i].key, dataFields[i].value);
+      strcpy(pushedFields[i], dataFields[i].value);
+      changed = true;
+    }
+  }
+  pushedVersion = dataVersion;
+  xSemaphoreGive(dataMutex);
 
-        .card {
-            background: var(--card-background);
-            border-radius: 5px;
-            padding: 15px;
-            text-align: center;
-            box-shadow: 0 2px 5px var(--shadow-color);
-            transition: transform 0.2s ease;
-        }
+  // Sent outside the lock so a slow socket never holds up publishData()
+  if (changed && length + 1 < sizeof(delta)) {
+    delta[length++] = '}';
+    webSocket.broadcastTXT(delta, length);
+  }
+}
 
-        .card:hover {
-            transform: translateY(-2px);
-        }
+// Copy the current /data body and its version out from under dataMutex
+static size_t copyDataJson(char* out, uint32_t& version) {
+  xSemaphoreTake(dataMutex, portMAX_DELAY);
+  memcpy(out, dataJson, dataJsonLength);
+  size_t length = dataJsonLength;
+  version = dataVersion;
+  xSemaphoreGive(dataMutex);
+  return length;
+}
 
-        .card h3 {
-            font-size: 1rem;
-            font-weight: 500;
-            color: var(--text-secondary);
-            margin-bottom: 0.5rem;
-        }
+// New dashboards get the full state once; after that they only see deltas
+void onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+  if (type == WStype_CONNECTED) {
+    char body[DATA_JSON_SIZE];
+    uint32_t version;
+    size_t bodyLength = copyDataJson(body, version);
+    webSocket.sendTXT(num, body, bodyLength);
+  }
+}
 
-        .card .value {
-            font-size: 1.875rem;
-            font-weight: 600;
-            color: var(--text-primary);
-        }
+// Conditional GET keyed on the publish version: each dashboard revalidates
+// with If-None-Match and gets a header-only 304 until something changes
+void handleData() {
+  char body[DATA_JSON_SIZE];
+  uint32_t version;
+  size_t length = copyDataJson(body, version);
+
+  char etag[24];
+  snprintf(etag, sizeof(etag), "\"%08lx-%lu\"", (unsigned long)bootId, (unsigned long)version);
+  server.sendHeader("ETag", etag);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (server.header("If-None-Match") == etag) {
+    server.send(304);
+    return;
+  }
 
-        .card .unit {
-            font-size: 0.875rem;
-            color: var(--text-secondary);
-            margin-left: 0.25rem;
-        }
+  server.send_P(200, "application/json", body, length);
+}
 
-        .system-status {
-            background: var(--card-background);
-            border-radius: 5px;
-            padding: 20px;
-            margin-bottom: 20px;
-            box-shadow: 0 2px 5px var(--shadow-color);
-        }
+// Stream /history?from=&to=&step=[&zone=][&format=bin]. `zone` is a zone name
+// as in /control, zone 1 if absent. Times are seconds since boot; the JSON
+// header carries "now" so the page can line them up with its clock.
+// Samples are decoded HISTORY_CHUNK_SAMPLES at a time and sent as chunks, so
+// neither side ever holds the whole range and historyMutex is only held for
+// one chunk's decode. format=bin sends raw little-endian HistorySample records.
+void handleHistory() {
+  uint32_t now = uptimeSeconds();
+  uint32_t from = server.hasArg("from") ? server.arg("from").toInt() : 0;
+  uint32_t to = server.hasArg("to") ? server.arg("to").toInt() : now;
+  uint32_t step = server.hasArg("step") ? max(1L, server.arg("step").toInt()) : 1;
+  bool binary = server.arg("format") == "bin";
+  uint8_t zone = 0;
+  if (server.hasArg("zone")) {
+    zone = ZONE_COUNT;
+    for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+      if (server.arg("zone") == zones[i]->name) {
+        zone = i;
+      }
+    }
+    if (zone == ZONE_COUNT) {
+      server.send(400, "text/plain", "Unknown zone");
+      return;
+    }
+  }
 
-        .system-status h2 {
-            font-size: 1.25rem;
-            font-weight: 600;
-            margin-bottom: 1.5rem;
-            color: var(--text-primary);
-        }
+  server.sendHeader("Cache-Control", "no-cache");
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, binary ? "application/octet-stream" : "application/json", "");
+
+  char text[1024];
+  size_t length = 0;
+  if (!binary) {
+    length = snprintf(text, sizeof(text),
+                      "{\"zone\":\"%s\",\"now\":%lu,\"step\":%lu,\"fields\":[\"time\",\"Temperature\","
+                      "\"Humidity\",\"VPD\",\"pH\",\"ReservoirVolume\",\"LightIntensity\"],\"samples\":[",
+                      zones[zone]->name, (unsigned long)now, (unsigned long)step);
+  }
 
-        .status-grid {
-            display: grid;
-            grid-template-columns: repeat(auto-fit, minmax(250px, 1fr));
-            gap: 1rem;
-        }
+  HistorySample samples[HISTORY_CHUNK_SAMPLES];
+  bool first = true;
+  for (;;) {
+    xSemaphoreTake(historyMutex, portMAX_DELAY);
+    size_t n = history[zone].read(from, to, step, samples, HISTORY_CHUNK_SAMPLES);
+    xSemaphoreGive(historyMutex);
+    if (n == 0) {
+      break;
+    }
 
-        .status-card {
-            display: flex;
-            align-items: center;
-            padding: 1rem;
-            background: var(--background-color);
-            border-radius: 0.5rem;
-            transition: transform 0.2s ease;
+    if (binary) {
+      server.sendContent((const char*)samples, n * sizeof(HistorySample));
+    } else {
+      for (size_t i = 0; i < n; i++) {
+        char values[6][DATA_FIELD_SIZE];
+        formatJsonNumber(values[0], DATA_FIELD_SIZE, samples[i].temperature, 1);
+        formatJsonNumber(values[1], DATA_FIELD_SIZE, samples[i].humidity, 1);
+        formatJsonNumber(values[2], DATA_FIELD_SIZE, samples[i].vpd, 2);
+        formatJsonNumber(values[3], DATA_FIELD_SIZE, samples[i].pH, 2);
+        formatJsonNumber(values[4], DATA_FIELD_SIZE, samples[i].reservoirVolume, 1);
+        formatJsonNumber(values[5], DATA_FIELD_SIZE, samples[i].lightIntensity, 0);
+        length += snprintf(text + length, sizeof(text) - length, "%s[%lu,%s,%s,%s,%s,%s,%s]",
+                           first ? "" : ",", (unsigned long)samples[i].time,
+                           values[0], values[1], values[2], values[3], values[4], values[5]);
+        first = false;
+        // A row is well under 128 bytes; flush before the next one could overflow
+        if (length > sizeof(text) - 128) {
+          server.sendContent(text, length);
+          length = 0;
         }
+      }
+    }
 
-        .status-card:hover {
-            transform: translateY(-2px);
-        }
+    if (n < HISTORY_CHUNK_SAMPLES) {
+      break;
+    }
+    from = samples[n - 1].time + step;
+  }
 
-        .status-icon {
-            width: 12px;
-            height: 12px;
-            border-radius: 50%;
-            margin-right: 1rem;
-            background-color: var(--text-secondary);
-        }
+  if (!binary) {
+    length += snprintf(text + length, sizeof(text) - length, "]}");
+    server.sendContent(text, length);
+  }
+  server.sendContent("");
+}
 
-        .status-icon.active {
-            background-color: var(--success-color);
-            box-shadow: 0 0 12px rgba(5, 150, 105, 0.4);
-        }
+// Prometheus scrape target. Timings are histograms in seconds plus min/avg/max
+// since the previous scrape; heap, stack and uptime figures are gauges read now.
+// Streamed in chunks like /history.
+void handleMetrics() {
+  TimingStat loopStat;
+  TimingStat stages[STAGE_COUNT];
+  TimingStat jobs[SCHEDULER_MAX_JOBS];
+  TimingStat requests[ROUTE_COUNT];
+  float duty[ZONE_COUNT];
+  MistUsage today[ZONE_COUNT];
+  MistUsage yesterday[ZONE_COUNT];
+  portENTER_CRITICAL(&metricsLock);
+  loopStat = loopTime.take();
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    stages[i] = stageTime[i].take();
+  }
+  for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+    jobs[i] = jobTime[i].take();
+  }
+  for (int i = 0; i < ROUTE_COUNT; i++) {
+    requests[i] = httpTime[i].take();
+  }
+  for (int i = 0; i < ZONE_COUNT; i++) {
+    duty[i] = mistDuty[i];
+    today[i] = mistToday[i];
+    yesterday[i] = mistYesterday[i];
+  }
+  portEXIT_CRITICAL(&metricsLock);
+
+  server.sendHeader("Cache-Control", "no-cache");
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain; version=0.0.4", "");
+
+  char text[1024];
+  MetricsWriter out(text, sizeof(text), [](const char* chunk, size_t length) {
+    server.sendContent(chunk, length);
+  });
+  char labels[40];
+
+  out.describe("aero_loop_seconds", "histogram", "Busy time of one loop() pass, excluding the idle wait");
+  out.histogram("aero_loop_seconds", "", loopStat);
+  out.describeWindow("aero_loop", "Busy time of one loop() pass");
+  out.window("aero_loop", "", loopStat);
+
+  out.describe("aero_loop_stage_seconds", "histogram", "Time per loop() pass in each stage");
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "{stage=\"%s\"}", stageNames[i]);
+    out.histogram("aero_loop_stage_seconds", labels, stages[i]);
+  }
+  out.describeWindow("aero_loop_stage", "Time per loop() pass in each stage");
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "{stage=\"%s\"}", stageNames[i]);
+    out.window("aero_loop_stage", labels, stages[i]);
+  }
 
-        .status-icon.warning {
-            background-color: var(--warning-color);
-            box-shadow: 0 0 12px rgba(217, 119, 6, 0.4);
-        }
+  out.describe("aero_job_seconds", "histogram", "Run time of each scheduler job");
+  for (int i = 0; i < scheduler.jobCount(); i++) {
+    snprintf(labels, sizeof(labels), "{job=\"%s\"}", jobNames[i]);
+    out.histogram("aero_job_seconds", labels, jobs[i]);
+  }
+  out.describeWindow("aero_job", "Run time of each scheduler job");
+  for (int i = 0; i < scheduler.jobCount(); i++) {
+    snprintf(labels, sizeof(labels), "{job=\"%s\"}", jobNames[i]);
+    out.window("aero_job", labels, jobs[i]);
+  }
 
-        .status-text {
-            font-size: 0.875rem;
-            font-weight: 500;
-            color: var(--text-primary);
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <header class="header">
-            <h1>Aeroponic Control System</h1>
-            <p>Real-time monitoring and control dashboard</p>
-        </header>
-
-        <div class="dashboard">
-            <div class="card">
-                <h3>Temperature</h3>
-                <div class="value" id="temp">--<span class="unit">°C</span></div>
-            </div>
-            <div class="card">
-                <h3>Humidity</h3>
-                <div class="value" id="hum">--<span class="unit">%</span></div>
-            </div>
-            <div class="card">
-                <h3>pH Level</h3>
-                <div class="value" id="ph">--</div>
-            </div>
-            <div class="card">
-                <h3>Reservoir Volume</h3>
-                <div class="value" id="rv">--<span class="unit">L</span></div>
-            </div>
-            <div class="card">
-                <h3>Light Intensity</h3>
-                <div class="value" id="li">--<span class="unit">lux</span></div>
-            </div>
-        </div>
-
-        <div class="system-status">
-            <h2>System Status</h2>
-            <div class="status-grid">
-                <div class="status-card" id="misting-status">
-                    <div class="status-icon"></div>
-                    <span class="status-text">Misting System Idle</span>
-                </div>
-                <div class="status-card" id="rotation-status">
-                    <div class="status-icon"></div>
-                    <span class="status-text">Rotation System Idle</span>
-                </div>
-                <div class="status-card" id="ph-status">
-                    <div class="status-icon"></div>
-                    <span class="status-text">pH System Stable</span>
-                </div>
-            </div>
-        </div>
-    </div>
-
-    <script>
-        const updateSensorData = async () => {
-            try {
-                const response = await fetch('/data');
-                const data = await response.json();
-                
-                const updateValue = (id, value) => {
-                    const element = document.getElementById(id);
-                    if (element) element.textContent = value;
-                };
-
-                updateValue('temp', data.Temperature);
-                updateValue('hum', data.Humidity);
-                updateValue('ph', data.pH);
-                updateValue('rv', data.ReservoirVolume);
-                updateValue('li', data.LightIntensity);
-
-                // Update system status indicators
-                const updateStatus = (id, isActive, text) => {
-                    const card = document.getElementById(id);
-                    if (card) {
-                        const icon = card.querySelector('.status-icon');
-                        const textEl = card.querySelector('.status-text');
-                        icon.className = 'status-icon ' + (isActive ? 'active' : '');
-                        textEl.textContent = text;
-                    }
-                };
-
-                // Misting System Status
-                updateStatus('misting-status', 
-                    data.isMisting,
-                    data.isMisting ? 'Misting System Active' : 'Misting System Idle'
-                );
-
-                // Rotation System Status
-                updateStatus('rotation-status',
-                    data.isRotating,
-                    data.isRotating ? 'System Rotating' : 'Rotation System Idle'
-                );
-
-                // pH System Status
-                const phStatusText = {
-                    'stable': 'pH System Stable',
-                    'adjusting': 'pH Adjustment in Progress',
-                    'completed': 'pH Adjustment Complete'
-                };
-                updateStatus('ph-status',
-                    data.phStatus !== 'stable',
-                    phStatusText[data.phStatus] || 'pH System Stable'
-                );
-            } catch (error) {
-                console.error('Error fetching sensor data:', error);
-            }
-        };
-
-        // Initialize
-        updateSensorData();
-        setInterval(updateSensorData, 2000);
-    </script>
-</body>
-</html>
-)rawliteral";
-  
-  server.send(200, "text/html", html);
-}
+  out.describe("aero_http_request_seconds", "histogram", "Handler time of each HTTP route");
+  for (int i = 0; i < ROUTE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "{path=\"%s\"}", routeNames[i]);
+    out.histogram("aero_http_request_seconds", labels, requests[i]);
+  }
+  out.describeWindow("aero_http_request", "Handler time of each HTTP route");
+  for (int i = 0; i < ROUTE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "{path=\"%s\"}", routeNames[i]);
+    out.window("aero_http_request", labels, requests[i]);
+  }
 
-// Optimize handleData() to reduce JSON processing
-void handleData() {
-  unsigned long currentTime = millis();
-  if (currentTime - lastDataUpdate < DATA_UPDATE_INTERVAL) {
-    server.send(304); // Not Modified
-    return;
+  out.describe("aero_mist_duty_ratio", "gauge", "Misting duty cycle the VPD controller is running");
+  for (int i = 0; i < ZONE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "{zone=\"%s\"}", zones[i]->name);
+    out.gauge("aero_mist_duty_ratio", labels, duty[i]);
   }
-  
-  lastDataUpdate = currentTime;
-  
-  String jsonString = "{";
-  jsonString += "\"Temperature\":\"" + String(temperature, 1) + " °C\",";
-  jsonString += "\"Humidity\":\"" + String(humidity, 1) + " %\",";
-  jsonString += "\"pH\":\"" + String(pH, 2) + "\",";
-  jsonString += "\"ReservoirVolume\":\"" + String(reservoirVolume, 1) + " L\",";
-  jsonString += "\"LightIntensity\":\"" + String(lightIntensity) + "\"";
-  jsonString += "}";
-  
-  server.sendHeader("Cache-Control", "max-age=1");
-  server.send(200, "application/json", jsonString);
+  out.describe("aero_mist_on_seconds", "gauge", "Misting pump on-time over the current and the last full day");
+  for (int i = 0; i < ZONE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "{zone=\"%s\",day=\"today\"}", zones[i]->name);
+    out.gauge("aero_mist_on_seconds", labels, today[i].onMs / 1000.0);
+    snprintf(labels, sizeof(labels), "{zone=\"%s\",day=\"yesterday\"}", zones[i]->name);
+    out.gauge("aero_mist_on_seconds", labels, yesterday[i].onMs / 1000.0);
+  }
+  out.describe("aero_mist_day_duty_ratio", "gauge", "Share of the day the misting pump ran");
+  for (int i = 0; i < ZONE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "{zone=\"%s\",day=\"today\"}", zones[i]->name);
+    out.gauge("aero_mist_day_duty_ratio", labels, today[i].duty());
+    snprintf(labels, sizeof(labels), "{zone=\"%s\",day=\"yesterday\"}", zones[i]->name);
+    out.gauge("aero_mist_day_duty_ratio", labels, yesterday[i].duty());
+  }
+  out.describe("aero_mist_energy_wh", "gauge", "Misting pump energy at MIST_PUMP_WATTS");
+  for (int i = 0; i < ZONE_COUNT; i++) {
+    snprintf(labels, sizeof(labels), "{zone=\"%s\",day=\"today\"}", zones[i]->name);
+    out.gauge("aero_mist_energy_wh", labels, today[i].energyWh());
+    snprintf(labels, sizeof(labels), "{zone=\"%s\",day=\"yesterday\"}", zones[i]->name);
+    out.gauge("aero_mist_energy_wh", labels, yesterday[i].energyWh());
+  }
+
+  out.describe("aero_heap_free_bytes", "gauge", "Free heap");
+  out.gauge("aero_heap_free_bytes", "", ESP.getFreeHeap());
+  out.describe("aero_heap_min_free_bytes", "gauge", "Lowest free heap since boot");
+  out.gauge("aero_heap_min_free_bytes", "", ESP.getMinFreeHeap());
+  out.describe("aero_heap_largest_free_block_bytes", "gauge", "Largest allocatable heap block");
+  out.gauge("aero_heap_largest_free_block_bytes", "", ESP.getMaxAllocHeap());
+  out.describe("aero_web_task_stack_free_bytes", "gauge", "Web task stack never used so far");
+  out.gauge("aero_web_task_stack_free_bytes", "", uxTaskGetStackHighWaterMark(webTaskHandle));
+  out.describe("aero_uptime_seconds", "gauge", "Seconds since boot");
+  out.gauge("aero_uptime_seconds", "", uptimeSeconds());
+  out.finish();
+  server.sendContent("");
 }
 
-// Optimize handleControl() to prevent rapid-fire requests
+// Queue one setpoint change from a JSON body for the control loop. Requests
+// closer than 100 ms apart are turned away with 429.
 void handleControl() {
   static unsigned long lastControlUpdate = 0;
   if (millis() - lastControlUpdate < 100) {
     server.send(429, "text/plain", "Too Many Requests");
     return;
   }
-  
-  if (server.hasArg("plain")) {
-    lastControlUpdate = millis();
-    String message;
-    DynamicJsonDocument doc(256);
-    DeserializationError error = deserializeJson(doc, server.arg("plain"));
-    
-    if (error) {
+  if (!server.hasArg("plain")) {
+    server.send(400, "text/plain", "Missing body");
+    return;
+  }
+
+  lastControlUpdate = millis();
+  const char* zoneNames[ZONE_COUNT];
+  for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+    zoneNames[i] = zones[i]->name;
+  }
+  ControlCommand command;
+  switch (parseControlCommand(server.arg("plain").c_str(), zoneNames, ZONE_COUNT, command)) {
+    case CONTROL_OK:
+      break;
+    case CONTROL_INVALID_JSON:
       server.send(400, "text/plain", "Invalid JSON");
       return;
-    }
-    
-    if (doc.containsKey("lightThreshold")) {
-      LIGHT_THRESHOLD = doc["lightThreshold"];
-      message = "Light threshold set to: " + String(LIGHT_THRESHOLD);
-    } else if (doc.containsKey("pHTarget")) {
-      PH_TARGET = doc["pHTarget"];
-      message = "pH target set to: " + String(PH_TARGET);
-    }
-    
-    server.send(200, "text/plain", message);
+    case CONTROL_UNKNOWN_ZONE:
+      server.send(400, "text/plain", "Unknown zone");
+      return;
+    case CONTROL_UNKNOWN_SETTING:
+      server.send(400, "text/plain", "Unknown setting");
+      return;
+  }
+
+  String message;
+  switch (command.type) {
+    case SET_LIGHT_THRESHOLD:
+      message = "Light threshold set to: " + String((int)command.value);
+      break;
+    case SET_PH_TARGET:
+      message = "pH target set to: " + String(command.value);
+      break;
+    case SET_VPD_LOW:
+      message = "VPD low set to: " + String(command.value);
+      break;
+    case SET_VPD_HIGH:
+      message = "VPD high set to: " + String(command.value);
+      break;
+    case RESET_PH_FAULT:
+      message = "pH fault reset";
+      break;
+  }
+
+  // The control loop applies it; this task never writes the setpoints
+  if (xQueueSend(commandQueue, &command, 0) != pdTRUE) {
+    server.send(503, "text/plain", "Controller busy");
+    return;
   }
+  server.send(200, "text/plain", message);
 }
 
 // Add this function to monitor AP connections (add after setup())
@@ -1,23 +1,96 @@
 #include <Wire.h>
 #include <WiFi.h>
-#include <WebSocketsClient.h>
-#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <time.h>
+#include <SocketIOclient.h>
+#include <mbedtls/base64.h>
+#include <esp_rtc_time.h>
 #include "Adafruit_SHT31.h"
+#include "uplink_batch.h"
+#include "uplink_queue.h"
 
 // WiFi credentials
 const char* ssid = "Tbag";
 const char* password = "Dbcooper";
 
-// WebSocket server details (we'll update this later with Vercel URL)
+// socket.io server details (we'll update this later with Vercel URL). The
+// server is frontend/src/pages/api/websocket.ts; socket.io speaks its own
+// protocol over the WebSocket, so a plain WebSocket client cannot reach it.
 const char* websocket_server = "your-app.vercel.app";
 const int websocket_port = 443;
-const char* websocket_path = "/api/websocket";
+const char* socketio_path = "/socket.io/?EIO=4";
 
 Adafruit_SHT31 sht31 = Adafruit_SHT31();
-WebSocketsClient webSocket;
+SocketIOclient socketIO;
+bool uplinkReady = false;  // Joined the server's namespace, so events go through
 
 unsigned long lastUpdate = 0;
-const long interval = 5000;  // Send data every 5 seconds
+const long interval = 5000;  // Sample every 5 seconds
+
+// Samples per uplink frame. Each frame costs a TLS record and WebSocket
+// framing whatever its size, so sending a minute of samples at once saves
+// most of the airtime; a sample in a batch takes a few bytes. 1 sends every
+// sample on its own as JSON text, as before.
+#define UPLINK_BATCH_SAMPLES 12
+#define UPLINK_CHANNELS 2  // Temperature, humidity
+
+UplinkBatch<UPLINK_CHANNELS> batch;
+uint8_t batchFrame[UPLINK_HEADER_SIZE + (UPLINK_BATCH_SAMPLES * UplinkBatch<UPLINK_CHANNELS>::MAX_SAMPLE_BITS + 7) / 8];
+
+// Batches the server could not take wait in flash and are replayed once it
+// is back, one bundle per REPLAY_INTERVAL so live batches still go out
+// first. 2 KB a second drains a full queue in about two minutes. A bundle
+// stays queued until the server acks its sequence number; without an ack
+// it is sent again after REPLAY_ACK_TIMEOUT or a reconnect.
+#define REPLAY_INTERVAL 1000
+#define REPLAY_BUNDLE_BYTES 2048
+#define REPLAY_ACK_TIMEOUT 10000
+
+UplinkQueue uplinkQueue;
+bool queueReady = false;
+uint8_t replayBundle[REPLAY_BUNDLE_BYTES];
+unsigned long lastReplay = 0;
+uint32_t awaitingAck = 0;  // Sequence number of the bundle in flight, 0 if none
+unsigned long bundleSentAt = 0;
+
+// Frames go out base64 in text events: SocketIOclient has no binary events
+char uplinkMessage[48 + 4 * ((REPLAY_BUNDLE_BYTES + 2) / 3)];
+
+// Queued records are dated from the device clock, which restarts with each
+// epoch: millis() and a new epoch every boot, or in LOW_POWER_MODE the RTC
+// timer and an epoch kept in RTC memory
+uint32_t clockEpoch = 0;
+
+// Battery mode: deep sleep between samples with the radio off, keeping the
+// readings in RTC slow memory, and wake WiFi only every
+// UPLINK_BATCH_SAMPLES-th sample to send them as one batch. Each wake is a
+// fresh boot through setup(). 0 keeps WiFi and the CPU up between samples.
+#define LOW_POWER_MODE 0
+#define SAMPLE_CPU_MHZ 80           // Enough for an SHT31 read
+#define WIFI_CONNECT_TIMEOUT 4000   // Give up and queue the batch after this
+#define UPLINK_CONNECT_TIMEOUT 6000 // TLS and WebSocket handshake
+#define CLOCK_SYNC_TIMEOUT 3000     // SNTP, only needed on the first flush after a power cycle
+#define UPLINK_ACK_TIMEOUT 4000     // Wait for each bundle's ack before the radio goes off
+#define UPLINK_DRAIN_MS 500         // Let an unacked live batch leave before the radio goes off
+#define REPLAY_BUNDLES_PER_WAKE 8   // Backlog sent per flush, 16 KB
+#define RTC_STATE_MAGIC 0x53454E31
+
+struct RtcSample {
+  uint32_t time;  // RTC clock in ms, which keeps running through deep sleep
+  float values[UPLINK_CHANNELS];
+};
+
+// Survives deep sleep, not a power cycle
+struct RtcState {
+  uint32_t magic;
+  uint32_t epoch;
+  uint32_t sensorFailures;  // Wakes without a reading
+  uint8_t count;
+  uint8_t channel;  // AP of the last connection, 0 if unknown
+  uint8_t bssid[6];
+  RtcSample samples[UPLINK_BATCH_SAMPLES];
+};
+RTC_DATA_ATTR RtcState rtcState;
 
 void setup() {
   Serial.begin(115200);
@@ -26,60 +99,358 @@ void setup() {
   // Initialize SHT31
   if (!sht31.begin(0x44)) {
     Serial.println("Couldn't find SHT31");
+#if LOW_POWER_MODE
+    beginRtcState();
+    rtcState.sensorFailures++;
+    deepSleep(interval);  // Try again next wake rather than hold the battery awake
+#endif
     while (1) delay(1);
   }
 
-  // Connect to WiFi
+  batch.begin(batchFrame, sizeof(batchFrame));
+  clockEpoch = esp_random();
+
+#if LOW_POWER_MODE
+  lowPowerWake();  // Ends in deep sleep
+#endif
+
+  beginQueue();
+
+  // Sampling starts without waiting for WiFi; whatever is taken offline
+  // goes to the queue. SNTP dates the queued batches once it has synced.
   WiFi.begin(ssid, password);
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
-  }
-  Serial.println("\nConnected to WiFi");
+  WiFi.setAutoReconnect(true);
+  configTime(0, 0, "pool.ntp.org");
 
-  // Setup WebSocket connection
-  webSocket.beginSSL(websocket_server, websocket_port, websocket_path);
-  webSocket.onEvent(webSocketEvent);
-  webSocket.setReconnectInterval(5000);
+  // Setup the socket.io connection
+  socketIO.beginSSL(websocket_server, websocket_port, socketio_path);
+  socketIO.onEvent(socketIOEvent);
+  socketIO.setReconnectInterval(5000);
 }
 
 void loop() {
-  webSocket.loop();
+  socketIO.loop();
 
   unsigned long currentMillis = millis();
   if (currentMillis - lastUpdate >= interval) {
     lastUpdate = currentMillis;
     sendSensorData();
   }
+
+  if (currentMillis - lastReplay >= REPLAY_INTERVAL) {
+    lastReplay = currentMillis;
+    replayQueue();
+  }
 }
 
 void sendSensorData() {
   float temp = sht31.readTemperature();
   float hum = sht31.readHumidity();
-  unsigned long currentTime = millis();
+  uint32_t currentTime = deviceMillis();
+
+  if (isnan(temp) || isnan(hum)) {
+    return;
+  }
+
+  if (UPLINK_BATCH_SAMPLES <= 1) {
+    int length = snprintf(uplinkMessage, sizeof(uplinkMessage),
+                          "[\"sensorData\",{\"temperature\":%.2f,\"humidity\":%.2f,\"timestamp\":%lu}]",
+                          temp, hum, (unsigned long)currentTime);
+    socketIO.sendEVENT(uplinkMessage, length);
+    return;
+  }
+
+  const float values[UPLINK_CHANNELS] = {temp, hum};
+  if (!batch.add(currentTime, values)) {
+    sendBatch();
+    batch.add(currentTime, values);
+  }
+  if (batch.samples() >= UPLINK_BATCH_SAMPLES) {
+    sendBatch();
+  }
+}
 
-  if (!isnan(temp) && !isnan(hum)) {
-    DynamicJsonDocument doc(128);
-    doc["temperature"] = temp;
-    doc["humidity"] = hum;
-    doc["timestamp"] = currentTime;
+void beginQueue() {
+  queueReady = LittleFS.begin(true);
+  if (queueReady) {
+    uplinkQueue.begin(LittleFS);
+    Serial.printf("Uplink queue: %u segments waiting\n", (unsigned)uplinkQueue.segmentCount());
+  } else {
+    Serial.println("LittleFS unavailable, batches sent while offline will be lost");
+  }
+}
 
-    String jsonString;
-    serializeJson(doc, jsonString);
-    webSocket.sendTXT(jsonString);
+// One frame for the whole batch, or into the queue if it cannot go
+void sendBatch() {
+  if (!uplinkReady || !emitFrame("sensorBatch", 0, batch.data(), batch.length())) {
+    queueBatch();
   }
+  batch.reset();
+}
+
+void queueBatch() {
+  uint32_t newest = batch.newestTime();
+  uint32_t now = unixTime();
+  uint32_t newestUnix = now != 0 ? now - (deviceMillis() - newest) / 1000 : 0;
+  uint32_t failures = uplinkQueue.flushFailures;
+  if (queueReady && uplinkQueue.push(batch.data(), batch.length(), clockEpoch, newest, newestUnix)) {
+    Serial.printf("Offline, queued %u samples\n", batch.samples());
+  } else {
+    Serial.printf("Uplink failed, dropped %u samples\n", batch.samples());
+  }
+  if (uplinkQueue.flushFailures != failures) {
+    Serial.printf("Queue write failed (%lu so far), %u bytes kept in RAM for the next try\n",
+                  (unsigned long)uplinkQueue.flushFailures, (unsigned)uplinkQueue.stagedBytes());
+  }
+}
+
+// Send the oldest queued batches as one bundle, unless one is still waiting
+// for its ack
+void replayQueue() {
+  if (!queueReady || uplinkQueue.empty() || !uplinkReady) {
+    return;
+  }
+  if (awaitingAck != 0 && millis() - bundleSentAt < REPLAY_ACK_TIMEOUT) {
+    return;
+  }
+  awaitingAck = 0;
+  UplinkClock now = {clockEpoch, deviceMillis(), unixTime()};
+  size_t length = uplinkQueue.nextBundle(replayBundle, sizeof(replayBundle), now);
+  if (length > 0 && emitFrame("sensorBundle", uplinkQueue.bundleSequence(), replayBundle, length)) {
+    awaitingAck = uplinkQueue.bundleSequence();
+    bundleSentAt = millis();
+  }
+}
+
+// Emit a socket.io event carrying `data` as base64, after `sequence` unless
+// that is 0
+bool emitFrame(const char* event, uint32_t sequence, const uint8_t* data, size_t length) {
+  size_t n = sequence != 0
+      ? snprintf(uplinkMessage, sizeof(uplinkMessage), "[\"%s\",%lu,\"", event, (unsigned long)sequence)
+      : snprintf(uplinkMessage, sizeof(uplinkMessage), "[\"%s\",\"", event);
+  size_t encoded;
+  // Room is left for the closing '"]' and the terminator
+  if (mbedtls_base64_encode((unsigned char*)uplinkMessage + n, sizeof(uplinkMessage) - n - 2, &encoded,
+                            data, length) != 0) {
+    return false;
+  }
+  n += encoded;
+  uplinkMessage[n++] = '"';
+  uplinkMessage[n++] = ']';
+  uplinkMessage[n] = '\0';
+  return socketIO.sendEVENT(uplinkMessage, n);
+}
+
+// Seconds since 1970, or 0 until SNTP has set the clock
+uint32_t unixTime() {
+  time_t now = time(NULL);
+  return now > 1600000000 ? (uint32_t)now : 0;
+}
+
+// The clock behind sample and queue times, in ms of the current clockEpoch
+uint32_t deviceMillis() {
+#if LOW_POWER_MODE
+  return rtcMillis();
+#else
+  return millis();
+#endif
 }
 
-void webSocketEvent(WStype_t type, uint8_t * payload, size_t length) {
+void socketIOEvent(socketIOmessageType_t type, uint8_t * payload, size_t length) {
   switch(type) {
-    case WStype_DISCONNECTED:
-      Serial.println("Disconnected from WebSocket server");
+    case sIOtype_DISCONNECT:
+      uplinkReady = false;
+      awaitingAck = 0;  // Its ack can no longer arrive; the bundle goes again
+      Serial.println("Disconnected from socket.io server, queueing batches");
       break;
-    case WStype_CONNECTED:
-      Serial.println("Connected to WebSocket server");
+    case sIOtype_CONNECT:
+      // First the transport connects, with the URL as payload; socket.io 3+
+      // then needs the namespace joined, which the server confirms with its sid
+      if (length > 0 && payload[0] == '{') {
+        uplinkReady = true;
+        Serial.printf("Connected to socket.io server, %u queued segments to replay\n",
+                      (unsigned)uplinkQueue.segmentCount());
+      } else {
+        socketIO.send(sIOtype_CONNECT, "/");
+      }
       break;
-    case WStype_TEXT:
-      Serial.printf("Received text: %s\n", payload);
+    case sIOtype_EVENT:
+      onServerEvent((const char*)payload);
       break;
+    default:
+      break;
+  }
+}
+
+// ["bundleAck",<sequence>] once the server has stored a replayed bundle
+void onServerEvent(const char* payload) {
+  const char* ackPrefix = "[\"bundleAck\",";
+  if (strncmp(payload, ackPrefix, strlen(ackPrefix)) != 0) {
+    return;
+  }
+  uint32_t acked = strtoul(payload + strlen(ackPrefix), NULL, 10);
+  if (acked == awaitingAck && uplinkQueue.acknowledge(acked)) {
+    awaitingAck = 0;
+  }
+}
+
+// One LOW_POWER_MODE wake: take a sample, flush if the batch is full, sleep
+void lowPowerWake() {
+  unsigned long wakeStart = millis();
+  beginRtcState();
+  setCpuFrequencyMhz(SAMPLE_CPU_MHZ);
+
+  float temp, hum;
+  if (!sht31.readBoth(&temp, &hum) || isnan(temp) || isnan(hum)) {
+    rtcState.sensorFailures++;
+  } else if (rtcState.count < UPLINK_BATCH_SAMPLES) {
+    RtcSample& sample = rtcState.samples[rtcState.count++];
+    sample.time = deviceMillis();
+    sample.values[0] = temp;
+    sample.values[1] = hum;
+  }
+
+  if (rtcState.count >= UPLINK_BATCH_SAMPLES) {
+    setCpuFrequencyMhz(240);
+    flushRtcSamples();
+  }
+
+  unsigned long awake = millis() - wakeStart;
+  deepSleep(awake < (unsigned long)interval - 100 ? interval - awake : 100);
+}
+
+// Pick up the RTC state from the last wake, or start it after a power cycle
+void beginRtcState() {
+  if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER || rtcState.magic != RTC_STATE_MAGIC) {
+    memset(&rtcState, 0, sizeof(rtcState));
+    rtcState.magic = RTC_STATE_MAGIC;
+    rtcState.epoch = esp_random();
+  }
+  clockEpoch = rtcState.epoch;
+}
+
+void deepSleep(uint32_t ms) {
+  Serial.flush();
+  esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+  esp_deep_sleep_start();
+}
+
+// Bring the radio up, send the RTC samples and some of the flash backlog, and
+// take it down again. The batch goes through the flash queue like the
+// backlog, so nothing is deleted before the server has acked it and the
+// radio only goes off once the acks are in or have timed out.
+void flushRtcSamples() {
+  for (uint8_t i = 0; i < rtcState.count; i++) {
+    batch.add(rtcState.samples[i].time, rtcState.samples[i].values);
+  }
+  rtcState.count = 0;
+  if (rtcState.sensorFailures > 0) {
+    Serial.printf("SHT31 failed on %lu wakes\n", (unsigned long)rtcState.sensorFailures);
   }
-} 
\ No newline at end of file
+
+  beginQueue();  // Only mounted on the wakes that need it
+  bool online = connectWiFiFast() && connectUplink();
+  if (queueReady) {
+    queueBatch();
+    batch.reset();
+    if (online) {
+      waitForClock();
+      replayAcked();
+    }
+    // RAM does not survive deep sleep, so this is the last try for the staged records
+    if (!uplinkQueue.flush()) {
+      Serial.printf("Queue write failed, %u staged bytes lost\n", (unsigned)uplinkQueue.stagedBytes());
+    }
+  } else if (online) {
+    // Nowhere to keep it; send it live and give it time to leave
+    sendBatch();
+    for (unsigned long start = millis(); millis() - start < UPLINK_DRAIN_MS;) {
+      socketIO.loop();
+      delay(10);
+    }
+  } else {
+    batch.reset();
+  }
+
+  socketIO.disconnect();
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+}
+
+// Join the AP from the last wake by channel and BSSID, which skips the scan.
+// Falls back to a full scan next time if that fails.
+bool connectWiFiFast() {
+  WiFi.persistent(false);
+  WiFi.mode(WIFI_STA);
+  if (rtcState.channel != 0) {
+    WiFi.begin(ssid, password, rtcState.channel, rtcState.bssid);
+  } else {
+    WiFi.begin(ssid, password);
+  }
+
+  unsigned long start = millis();
+  while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - start >= WIFI_CONNECT_TIMEOUT) {
+      Serial.println("WiFi connect timed out, queueing the batch");
+      rtcState.channel = 0;
+      return false;
+    }
+    delay(10);
+  }
+  rtcState.channel = WiFi.channel();
+  memcpy(rtcState.bssid, WiFi.BSSID(), sizeof(rtcState.bssid));
+  configTime(0, 0, "pool.ntp.org");
+  return true;
+}
+
+bool connectUplink() {
+  socketIO.beginSSL(websocket_server, websocket_port, socketio_path);
+  socketIO.onEvent(socketIOEvent);
+  unsigned long start = millis();
+  while (!uplinkReady) {
+    if (millis() - start >= UPLINK_CONNECT_TIMEOUT) {
+      Serial.println("Uplink connect timed out, queueing the batch");
+      return false;
+    }
+    socketIO.loop();
+    delay(10);
+  }
+  return true;
+}
+
+// Queued batches are dated from the clock, so give SNTP a moment if it has
+// not set it yet. The system clock keeps running through deep sleep, so this
+// only waits on the first flush after a power cycle.
+void waitForClock() {
+  unsigned long start = millis();
+  while (unixTime() == 0 && millis() - start < CLOCK_SYNC_TIMEOUT) {
+    delay(10);
+  }
+}
+
+// Send up to REPLAY_BUNDLES_PER_WAKE bundles, each after the previous one
+// was acked. Stops at the first missing ack; the rest stays queued.
+void replayAcked() {
+  for (int i = 0; i < REPLAY_BUNDLES_PER_WAKE && uplinkReady && !uplinkQueue.empty(); i++) {
+    replayQueue();
+    if (awaitingAck == 0) {
+      return;  // Nothing that can be sent yet
+    }
+    unsigned long start = millis();
+    while (awaitingAck != 0 && uplinkReady && millis() - start < UPLINK_ACK_TIMEOUT) {
+      socketIO.loop();
+      delay(10);
+    }
+    if (awaitingAck != 0) {
+      Serial.println("No ack from the server, keeping the backlog queued");
+      return;
+    }
+  }
+}
+
+// The RTC timer in ms. Unlike millis() it is not reset by deep sleep, so
+// samples from different wakes keep their spacing, and unlike the system
+// clock SNTP does not move it.
+uint32_t rtcMillis() {
+  return (uint32_t)(esp_rtc_get_time_us() / 1000);
+}
@@ -0,0 +1,197 @@
+#ifndef UPLINK_BATCH_H
+#define UPLINK_BATCH_H
+
+#include <Arduino.h>
+
+// Batches of samples packed into one binary WebSocket frame, compressed the
+// way Gorilla (Facebook's in-memory TSDB) packs time series: timestamps as
+// delta-of-delta, values as the XOR with the previous value of the channel.
+// A steady sample interval costs one bit per timestamp, and a value that
+// changed a little costs its few differing bits.
+//
+// Frame layout:
+//
+//   byte 0      UPLINK_FORMAT_VERSION
+//   byte 1      sample count
+//   bytes 2-5   first timestamp, ms since boot, little endian
+//   bits        first sample's values, 32 raw bits each; then per further
+//               sample the timestamp and each value as below. MSB first,
+//               zero-padded to a whole byte.
+//
+// Timestamp, dod = (t[i] - t[i-1]) - (t[i-1] - t[i-2]), with t[-1] = t[0]:
+//   '0'                   dod == 0
+//   '10'   + 7 bits       -64..63
+//   '110'  + 9 bits       -256..255
+//   '1110' + 12 bits      -2048..2047
+//   '1111' + 32 bits      anything else
+//
+// Value, x = bits ^ previous bits:
+//   '0'                   x == 0
+//   '10' + meaningful bits, in the previous leading/trailing zero window
+//   '11' + 5 bits leading zeros + 5 bits (length - 1) + length bits
+//
+// Before encoding, values are rounded to UPLINK_MANTISSA_BITS of mantissa
+// (about 0.004 °C and 0.008 %RH around room conditions, well under the
+// SHT31's resolution), so the XORs end in zeros instead of float noise.
+//
+// frontend/src/lib/uplink.ts decodes this; keep the two in step.
+
+#define UPLINK_FORMAT_VERSION 1
+#define UPLINK_HEADER_SIZE 6
+#define UPLINK_MANTISSA_BITS 12
+
+template <uint8_t Channels>
+class UplinkBatch {
+public:
+  // Worst case for one sample: a 36-bit timestamp and 44 bits per value
+  static const size_t MAX_SAMPLE_BITS = 36 + 44 * Channels;
+
+  void begin(uint8_t* buffer, size_t size) {
+    frame = buffer;
+    capacity = size;
+    reset();
+  }
+
+  // Start a new, empty batch in the same buffer
+  void reset() {
+    count = 0;
+    bitLength = UPLINK_HEADER_SIZE * 8;
+    memset(frame, 0, capacity);
+  }
+
+  // Add a sample. Returns false, leaving the batch unchanged, if it might not
+  // fit; send the batch and reset() first.
+  bool add(uint32_t time, const float* values) {
+    if (count == 255 || bitLength + MAX_SAMPLE_BITS > capacity * 8) {
+      return false;
+    }
+
+    uint32_t bits[Channels];
+    for (uint8_t c = 0; c < Channels; c++) {
+      bits[c] = roundMantissa(values[c]);
+    }
+
+    if (count == 0) {
+      frame[0] = UPLINK_FORMAT_VERSION;
+      frame[2] = time;
+      frame[3] = time >> 8;
+      frame[4] = time >> 16;
+      frame[5] = time >> 24;
+      for (uint8_t c = 0; c < Channels; c++) {
+        writeBits(bits[c], 32);
+        channels[c].bits = bits[c];
+        channels[c].leading = 32;  // No window yet
+        channels[c].trailing = 0;
+      }
+      lastDelta = 0;
+    } else {
+      uint32_t delta = time - lastTime;
+      writeTimestamp((int32_t)(delta - lastDelta));
+      lastDelta = delta;
+      for (uint8_t c = 0; c < Channels; c++) {
+        writeValue(channels[c], bits[c]);
+      }
+    }
+    lastTime = time;
+    count++;
+    frame[1] = count;
+    return true;
+  }
+
+  uint8_t samples() const {
+    return count;
+  }
+
+  // Timestamp of the last sample added
+  uint32_t newestTime() const {
+    return lastTime;
+  }
+
+  const uint8_t* data() const {
+    return frame;
+  }
+
+  size_t length() const {
+    return (bitLength + 7) / 8;
+  }
+
+private:
+  struct Channel {
+    uint32_t bits;
+    uint8_t leading;
+    uint8_t trailing;
+  };
+
+  static uint32_t roundMantissa(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint8_t dropped = 23 - UPLINK_MANTISSA_BITS;
+    if ((bits & 0x7F800000) == 0x7F800000) {
+      return bits;  // Inf and NaN stay as they are
+    }
+    return (bits + (1UL << (dropped - 1))) & ~((1UL << dropped) - 1);
+  }
+
+  void writeBits(uint32_t value, uint8_t n) {
+    while (n > 0) {
+      n--;
+      if ((value >> n) & 1) {
+        frame[bitLength / 8] |= 0x80 >> (bitLength % 8);
+      }
+      bitLength++;
+    }
+  }
+
+  void writeTimestamp(int32_t dod) {
+    if (dod == 0) {
+      writeBits(0b0, 1);
+    } else if (dod >= -64 && dod <= 63) {
+      writeBits(0b10, 2);
+      writeBits(dod, 7);
+    } else if (dod >= -256 && dod <= 255) {
+      writeBits(0b110, 3);
+      writeBits(dod, 9);
+    } else if (dod >= -2048 && dod <= 2047) {
+      writeBits(0b1110, 4);
+      writeBits(dod, 12);
+    } else {
+      writeBits(0b1111, 4);
+      writeBits(dod, 32);
+    }
+  }
+
+  void writeValue(Channel& channel, uint32_t bits) {
+    uint32_t x = bits ^ channel.bits;
+    channel.bits = bits;
+    if (x == 0) {
+      writeBits(0b0, 1);
+      return;
+    }
+
+    uint8_t leading = min(__builtin_clz(x), 31);
+    uint8_t trailing = __builtin_ctz(x);
+    if (leading >= channel.leading && trailing >= channel.trailing) {
+      writeBits(0b10, 2);
+      writeBits(x >> channel.trailing, 32 - channel.leading - channel.trailing);
+      return;
+    }
+
+    uint8_t length = 32 - leading - trailing;
+    writeBits(0b11, 2);
+    writeBits(leading, 5);
+    writeBits(length - 1, 5);
+    writeBits(x >> trailing, length);
+    channel.leading = leading;
+    channel.trailing = trailing;
+  }
+
+  uint8_t* frame = NULL;
+  size_t capacity = 0;
+  size_t bitLength = 0;
+  uint8_t count = 0;
+  uint32_t lastTime = 0;
+  uint32_t lastDelta = 0;
+  Channel channels[Channels];
+};
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef UPLINK_QUEUE_H
+#define UPLINK_QUEUE_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// Store-and-forward queue for uplink frames the WebSocket could not take.
+//
+// Frames are appended to segment files of at most UPLINK_SEGMENT_BYTES (one
+// flash erase block) named by a rising number. Nothing is rewritten in place:
+// a segment is only ever appended to and then deleted once replayed, and
+// appends are staged in RAM and written UPLINK_STAGING_BYTES at a time, so
+// the flash sees few, large writes. At most UPLINK_MAX_SEGMENTS exist; when
+// a new one is needed past that, the oldest is deleted unsent. A staged
+// write the flash does not take stays staged and is tried again by the next
+// flush(); meanwhile push() refuses frames that no longer fit.
+//
+// Each record is
+//
+//   u16 frame length, u32 clock epoch, u32 device time of the frame's newest
+//   sample in ms, u32 unix time of that sample (0 if the clock was not set),
+//   the frame
+//
+// all little endian. The device clock restarts with each epoch (a boot, in
+// the sketch's terms), so a record pushed before SNTP synced is dated when
+// it is replayed, from the epoch's current device and unix time. Until the
+// clock is set such records wait; records of an earlier epoch that were
+// never dated cannot be any more and go out with unix time 0 for the server
+// to drop.
+//
+// Replay copies records into bundles: a UPLINK_BUNDLE_VERSION byte followed
+// by records of u16 frame length, u32 unix time, the frame, which the server
+// splits (frontend/src/lib/uplink.ts). Each bundle has a sequence number the
+// server acknowledges once it has stored the bundle; only then does
+// acknowledge() move past it. Progress within a segment is kept in RAM only,
+// so a lost ack or a reset mid-segment sends records again: delivery is at
+// least once.
+//
+// Not thread-safe; call it from loop() only.
+
+#define UPLINK_QUEUE_DIR "/uplink"
+#define UPLINK_SEGMENT_BYTES 4096
+#define UPLINK_MAX_SEGMENTS 64  // 256 KB of flash at most
+#define UPLINK_STAGING_BYTES 512
+#define UPLINK_RECORD_HEADER 14
+#define UPLINK_BUNDLE_RECORD_HEADER 6
+#define UPLINK_BUNDLE_VERSION 2
+
+// The sketch's clock as nextBundle() sees it
+struct UplinkClock {
+  uint32_t epoch;       // Changes whenever deviceTime restarts
+  uint32_t deviceTime;  // ms
+  uint32_t unixTime;    // s, 0 until set
+};
+
+class UplinkQueue {
+public:
+  // Picks up whatever segments a previous boot left behind
+  void begin(fs::FS& filesystem) {
+    storage = &filesystem;
+    storage->mkdir(UPLINK_QUEUE_DIR);
+    firstSegment = 0;
+    lastSegment = 0;
+    lastSegmentSize = 0;
+    segments = 0;
+    File dir = storage->open(UPLINK_QUEUE_DIR);
+    for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+      uint32_t id = strtoul(baseName(file.name()), NULL, 10);
+      if (segments == 0 || id < firstSegment) {
+        firstSegment = id;
+      }
+      if (segments == 0 || id > lastSegment) {
+        lastSegment = id;
+        lastSegmentSize = file.size();
+      }
+      segments++;
+    }
+    readOffset = 0;
+    staged = 0;
+  }
+
+  // Queue one frame whose newest sample was taken at `deviceTime` of `epoch`.
+  // Returns false if it can never fit in a segment.
+  bool push(const uint8_t* frame, size_t length, uint32_t epoch, uint32_t deviceTime, uint32_t unixTime) {
+    size_t recordLength = UPLINK_RECORD_HEADER + length;
+    if (recordLength > UPLINK_STAGING_BYTES) {
+      return false;
+    }
+    if ((staged + recordLength > UPLINK_STAGING_BYTES ||
+         lastSegmentSize + staged + recordLength > UPLINK_SEGMENT_BYTES) &&
+        !flush()) {
+      return false;
+    }
+    if (segments == 0 || lastSegmentSize + recordLength > UPLINK_SEGMENT_BYTES) {
+      startSegment();
+    }
+
+    uint8_t* record = staging + staged;
+    record[0] = length;
+    record[1] = length >> 8;
+    writeU32(record + 2, epoch);
+    writeU32(record + 6, deviceTime);
+    writeU32(record + 10, unixTime);
+    memcpy(record + UPLINK_RECORD_HEADER, frame, length);
+    staged += recordLength;
+    queuedFrames++;
+    return true;
+  }
+
+  // Write the staged records to the newest segment. On failure they stay
+  // staged for the next call and flushFailures counts it; a write that got
+  // only part of the way leaves a torn tail, which the reader skips, and the
+  // retry goes to a fresh segment.
+  bool flush() {
+    if (staged == 0) {
+      return true;
+    }
+    char path[24];
+    File file = storage->open(segmentPath(lastSegment, path), "a");
+    if (!file) {
+      flushFailures++;
+      return false;
+    }
+    size_t written = file.write(staging, staged);
+    lastSegmentSize = file.size();
+    file.close();
+    if (written != staged) {
+      flushFailures++;
+      if (written > 0) {
+        startSegment();
+      }
+      return false;
+    }
+    staged = 0;
+    return true;
+  }
+
+  bool empty() const {
+    return segments == 0 && staged == 0;
+  }
+
+  // Fill `out` with a bundle of the oldest records, at most `size` bytes,
+  // dated against `now`. Returns its length, 0 if there is nothing to send
+  // yet. Send it tagged with bundleSequence() and call acknowledge() with the
+  // server's ack; until then the same records come back next time.
+  size_t nextBundle(uint8_t* out, size_t size, const UplinkClock& now) {
+    flush();
+    bundleEnd = readOffset;
+    bundleSegment = firstSegment;
+    if (segments == 0 || size <= 1) {
+      return 0;
+    }
+
+    char path[24];
+    File file = storage->open(segmentPath(firstSegment, path), "r");
+    if (!file) {
+      dropFirst();
+      return 0;
+    }
+    file.seek(readOffset);
+    size_t length = 1;
+    out[0] = UPLINK_BUNDLE_VERSION;
+    uint8_t header[UPLINK_RECORD_HEADER];
+    bool waiting = false;
+    while (file.read(header, sizeof(header)) == sizeof(header)) {
+      size_t body = header[0] | (header[1] << 8);
+      if (length + UPLINK_BUNDLE_RECORD_HEADER + body > size) {
+        break;
+      }
+      uint32_t unixTime;
+      if (!dateRecord(header, now, unixTime)) {
+        waiting = true;  // The clock may still be set; keep it and what follows
+        break;
+      }
+      uint8_t* record = out + length;
+      record[0] = header[0];
+      record[1] = header[1];
+      writeU32(record + 2, unixTime);
+      if (file.read(record + UPLINK_BUNDLE_RECORD_HEADER, body) != body) {
+        break;  // Torn write at the end of the segment; drop the rest
+      }
+      length += UPLINK_BUNDLE_RECORD_HEADER + body;
+      bundleEnd += UPLINK_RECORD_HEADER + body;
+    }
+    bool atEnd = !waiting && !file.available();
+    file.close();
+    if (length == 1) {
+      if (atEnd) {
+        dropFirst();  // Nothing readable left in this segment
+      }
+      return 0;
+    }
+    sequence++;
+    return length;
+  }
+
+  // Sequence number of the last bundle from nextBundle()
+  uint32_t bundleSequence() const {
+    return sequence;
+  }
+
+  // The server has stored bundle `acked`; move past it. Returns false for an
+  // ack of anything but the last bundle, which is then sent again. Records
+  // pushed since nextBundle() may have gone to the same segment, which then stays.
+  bool acknowledge(uint32_t acked) {
+    if (acked == 0 || acked != sequence || bundleEnd == readOffset) {
+      return false;
+    }
+    if (segments > 0 && firstSegment == bundleSegment) {
+      if (bundleEnd >= segmentSize(firstSegment) && !(staged > 0 && firstSegment == lastSegment)) {
+        dropFirst();
+      } else {
+        readOffset = bundleEnd;
+      }
+    }
+    bundleEnd = readOffset;  // A repeated ack changes nothing
+    return true;
+  }
+
+  size_t segmentCount() const {
+    return segments;
+  }
+
+  // Bytes waiting in RAM for the next flush()
+  size_t stagedBytes() const {
+    return staged;
+  }
+
+  uint32_t droppedSegments = 0;
+  uint32_t queuedFrames = 0;
+  uint32_t flushFailures = 0;
+
+private:
+  static const char* baseName(const char* name) {
+    const char* slash = strrchr(name, '/');
+    return slash != NULL ? slash + 1 : name;
+  }
+
+  static void writeU32(uint8_t* out, uint32_t value) {
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+  }
+
+  static uint32_t readU32(const uint8_t* in) {
+    return in[0] | (in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+  }
+
+  // The unix time of a record's newest sample: as stored, or counted back
+  // from `now` if it is from the current epoch. False while it could still
+  // be dated once the clock is set.
+  static bool dateRecord(const uint8_t* header, const UplinkClock& now, uint32_t& unixTime) {
+    unixTime = readU32(header + 10);
+    if (unixTime != 0 || readU32(header + 2) != now.epoch) {
+      return true;  // Dated, or never will be
+    }
+    if (now.unixTime == 0) {
+      return false;
+    }
+    unixTime = now.unixTime - (now.deviceTime - readU32(header + 6)) / 1000;
+    return true;
+  }
+
+  size_t segmentSize(uint32_t id) {
+    if (id == lastSegment) {
+      return lastSegmentSize;
+    }
+    char path[24];
+    File file = storage->open(segmentPath(id, path), "r");
+    size_t size = file ? file.size() : 0;
+    file.close();
+    return size;
+  }
+
+  static const char* segmentPath(uint32_t id, char* path) {
+    snprintf(path, 24, UPLINK_QUEUE_DIR "/%08lu", (unsigned long)id);
+    return path;
+  }
+
+  void startSegment() {
+    if (segments >= UPLINK_MAX_SEGMENTS) {
+      dropFirst();
+      droppedSegments++;
+    }
+    lastSegment++;
+    if (segments == 0) {
+      firstSegment = lastSegment;
+    }
+    lastSegmentSize = 0;
+    segments++;
+  }
+
+  // Delete the oldest segment, sent or not
+  void dropFirst() {
+    if (segments == 0) {
+      return;
+    }
+    char path[24];
+    storage->remove(segmentPath(firstSegment, path));
+    readOffset = 0;
+    segments--;
+    if (segments == 0) {
+      lastSegmentSize = 0;
+    } else {
+      firstSegment++;
+    }
+  }
+
+  fs::FS* storage = NULL;
+  uint32_t firstSegment = 0;
+  uint32_t lastSegment = 0;
+  size_t lastSegmentSize = 0;
+  size_t segments = 0;
+  size_t readOffset = 0;
+  size_t bundleEnd = 0;
+  uint32_t bundleSegment = 0;
+  uint32_t sequence = 0;
+  uint8_t staging[UPLINK_STAGING_BYTES];
+  size_t staged = 0;
+};
+
+#endif
@@ -0,0 +1,194 @@
+// Generated by tools/embed_html.py from web/esp32_dashboard.html - do not edit
+// 8937 bytes minified, 2875 bytes gzipped
+#ifndef ESP32_DASHBOARD_HTML_H
+#define ESP32_DASHBOARD_HTML_H
+
+#include <Arduino.h>
+
+#define ESP32_DASHBOARD_ETAG "\"ab4209788c02504c\""
+
+const size_t ESP32_DASHBOARD_GZ_LEN = 2875;
+const uint8_t ESP32_DASHBOARD_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x5a, 0xeb, 0x72, 0xdb, 0xb8,
+  0x15, 0xfe, 0xaf, 0xa7, 0x40, 0xd4, 0x64, 0x49, 0xcd, 0x4a, 0x14, 0xa5, 0x44, 0x4e, 0x2c, 0x4b,
+  0xee, 0xa4, 0x4e, 0x32, 0x49, 0x27, 0xdd, 0x78, 0x12, 0x37, 0x3b, 0x5b, 0xd7, 0x1d, 0x43, 0x24,
+  0x24, 0x22, 0xa6, 0x08, 0x16, 0x84, 0x64, 0x3b, 0x5e, 0xbf, 0x53, 0x9f, 0xa1, 0x4f, 0xd6, 0x73,
+  0x00, 0xf0, 0x2a, 0xc9, 0x76, 0xb2, 0xe9, 0x24, 0x23, 0x91, 0xc0, 0xb9, 0x7c, 0x38, 0x77, 0x52,
+  0x9e, 0x3c, 0x7a, 0xf5, 0xe1, 0xe8, 0xe4, 0xb7, 0xe3, 0xd7, 0x24, 0x52, 0xcb, 0xf8, 0xb0, 0x35,
+  0xc1, 0x2f, 0x12, 0xd3, 0x64, 0x31, 0x6d, 0xb3, 0xa4, 0x8d, 0x0b, 0x8c, 0x86, 0xf0, 0xb5, 0x64,
+  0x8a, 0x92, 0x20, 0xa2, 0x32, 0x63, 0x6a, 0xda, 0xfe, 0xfb, 0xc9, 0x9b, 0xde, 0x8b, 0x76, 0xbe,
+  0x9c, 0xd0, 0x25, 0x9b, 0xb6, 0xd7, 0x9c, 0x5d, 0xa6, 0x42, 0xaa, 0x36, 0x09, 0x44, 0xa2, 0x58,
+  0x02, 0x64, 0x97, 0x3c, 0x54, 0xd1, 0x34, 0x64, 0x6b, 0x1e, 0xb0, 0x9e, 0xbe, 0xe9, 0x12, 0x9e,
+  0x70, 0xc5, 0x69, 0xdc, 0xcb, 0x02, 0x1a, 0xb3, 0xe9, 0xc0, 0xf3, 0x51, 0x8c, 0xe2, 0x2a, 0x66,
+  0x87, 0x2f, 0x99, 0x14, 0xa9, 0x48, 0x78, 0x40, 0x8e, 0x40, 0x82, 0x14, 0x31, 0xf9, 0x74, 0x9d,
+  0x29, 0xb6, 0x9c, 0xf4, 0xcd, 0x7e, 0x6b, 0x92, 0xa9, 0x6b, 0xfc, 0x1e, 0x4b, 0x21, 0x14, 0xb9,
+  0x69, 0xf5, 0x7a, 0xa9, 0xe4, 0x4b, 0x2a, 0xaf, 0x7b, 0x0b, 0x49, 0x43, 0x0e, 0x3a, 0x7b, 0x99,
+  0xa2, 0x52, 0x8d, 0xc9, 0x9f, 0x5e, 0x3c, 0x9b, 0xd3, 0x99, 0x7f, 0xb0, 0x8d, 0x84, 0x25, 0x21,
+  0x12, 0xcc, 0xc3, 0xa7, 0xf3, 0x67, 0x48, 0x10, 0x50, 0x19, 0xf6, 0x66, 0x34, 0xb8, 0x58, 0x48,
+  0xb1, 0xc2, 0x3d, 0xb9, 0x98, 0x51, 0x77, 0x38, 0x1a, 0x75, 0x49, 0xf9, 0xe1, 0x7b, 0xfb, 0x1d,
+  0x24, 0x56, 0xec, 0x4a, 0xe5, 0x22, 0x41, 0xca, 0x30, 0x78, 0xca, 0x46, 0x7e, 0xb1, 0x91, 0x31,
+  0x38, 0x7b, 0x68, 0xb6, 0x46, 0xf4, 0x39, 0xdd, 0xd7, 0x0a, 0xb2, 0x55, 0x10, 0xb0, 0x2c, 0xeb,
+  0x05, 0x22, 0x16, 0x12, 0x76, 0xfc, 0xd1, 0xfe, 0xde, 0xde, 0x3e, 0xee, 0x5c, 0x52, 0x99, 0xf0,
+  0x64, 0x51, 0xec, 0x84, 0xfb, 0xcf, 0x9f, 0xfb, 0x7b, 0x9a, 0x27, 0xa2, 0xa1, 0xb8, 0xcc, 0x37,
+  0x34, 0x22, 0x1f, 0x50, 0x98, 0xff, 0xde, 0x00, 0xb0, 0xdc, 0xb6, 0x66, 0x22, 0xbc, 0x06, 0x2b,
+  0xcc, 0xc1, 0x58, 0xbd, 0x39, 0x5d, 0xf2, 0x18, 0xd4, 0xbe, 0x94, 0x60, 0xdc, 0x2e, 0xc9, 0x68,
+  0x92, 0x01, 0x1a, 0xc9, 0xe7, 0x07, 0xad, 0xea, 0xd1, 0x62, 0x9e, 0x30, 0x2a, 0x0b, 0x5b, 0xb8,
+  0x83, 0xa1, 0x1f, 0xb2, 0x45, 0x97, 0xac, 0xa9, 0x74, 0x77, 0x59, 0xb3, 0x43, 0xfc, 0x27, 0x3b,
+  0x29, 0xc0, 0x98, 0x1d, 0x32, 0xf0, 0xfd, 0x27, 0x80, 0x08, 0x76, 0x16, 0x3c, 0x19, 0x13, 0xb0,
+  0x47, 0x4a, 0xc3, 0x10, 0x0e, 0x36, 0x26, 0x43, 0x3f, 0xbd, 0x3a, 0x68, 0xd9, 0x63, 0x18, 0x19,
+  0x55, 0x13, 0x22, 0x17, 0x4f, 0x7a, 0x11, 0xe3, 0x8b, 0x08, 0xdc, 0x06, 0x82, 0xd6, 0x11, 0x1e,
+  0xcd, 0xc3, 0x18, 0xa2, 0x00, 0x56, 0xc2, 0x01, 0x97, 0xf4, 0xca, 0x44, 0x0f, 0x10, 0x0c, 0x7d,
+  0x2d, 0x30, 0x57, 0x35, 0x94, 0x6c, 0x49, 0xe8, 0x4a, 0x89, 0x8a, 0x4a, 0x9f, 0x0c, 0x60, 0x55,
+  0x4b, 0xc1, 0xe0, 0xd5, 0x22, 0xb4, 0x4e, 0x1a, 0xf3, 0x05, 0xf0, 0x04, 0x80, 0x9b, 0xc9, 0x5c,
+  0x46, 0x6f, 0x26, 0x94, 0x12, 0x4b, 0x23, 0xaa, 0xca, 0x14, 0x0d, 0x72, 0xdb, 0x66, 0xfc, 0x2b,
+  0x83, 0x7d, 0x6f, 0x38, 0xd2, 0x24, 0x7a, 0xed, 0xd2, 0x22, 0xde, 0xf3, 0xfd, 0x7b, 0x8e, 0x57,
+  0xd7, 0xe2, 0x7b, 0xa3, 0x86, 0x9e, 0x14, 0xd4, 0x6c, 0x0a, 0x28, 0x22, 0x49, 0x7b, 0xda, 0x0b,
+  0x69, 0x16, 0xcd, 0x04, 0x04, 0x2a, 0x10, 0x87, 0x3c, 0x4b, 0x63, 0x0a, 0xbe, 0x5e, 0x48, 0x1e,
+  0x1e, 0xb4, 0xf0, 0x13, 0x78, 0x96, 0xb0, 0xa6, 0x18, 0x06, 0xcc, 0x6a, 0x99, 0x64, 0x10, 0x32,
+  0x2c, 0x65, 0x54, 0xb9, 0x68, 0x9b, 0xde, 0x9c, 0xab, 0x2e, 0x01, 0x3b, 0x83, 0x21, 0xdd, 0xe1,
+  0x0b, 0x30, 0x60, 0x97, 0x0c, 0xe6, 0xb2, 0x03, 0xa2, 0x17, 0x34, 0x05, 0xa3, 0x5a, 0x4c, 0xbb,
+  0x0c, 0x12, 0x18, 0xbd, 0xd5, 0x38, 0x32, 0x48, 0x1b, 0x99, 0x03, 0xf2, 0x66, 0x42, 0xc2, 0x99,
+  0x7a, 0x18, 0x1d, 0x2b, 0x00, 0x31, 0x42, 0x5f, 0x15, 0x8e, 0x19, 0xe8, 0xdb, 0x6d, 0xae, 0x98,
+  0x89, 0x2b, 0x1b, 0xf1, 0xe8, 0xbe, 0x61, 0x7a, 0x85, 0x9c, 0x56, 0x49, 0x35, 0x13, 0x40, 0x83,
+  0x92, 0x10, 0xda, 0x50, 0x42, 0x04, 0xb0, 0xeb, 0xeb, 0xb9, 0x90, 0x4b, 0x30, 0xeb, 0x30, 0x23,
+  0x8c, 0x66, 0xac, 0x00, 0x3c, 0x8e, 0xc4, 0xda, 0xb8, 0x3e, 0x27, 0xb2, 0xf4, 0x68, 0xa6, 0xdf,
+  0xdc, 0x1e, 0x28, 0xe9, 0x94, 0xa7, 0x8b, 0x9e, 0xd6, 0x9d, 0x3d, 0xd8, 0xf4, 0xf4, 0x68, 0xbb,
+  0xa7, 0xab, 0x8e, 0xda, 0xed, 0x6b, 0xad, 0xc4, 0x5b, 0xd3, 0x78, 0xc5, 0x1a, 0x8a, 0xbc, 0x17,
+  0xcf, 0xbf, 0x27, 0xac, 0x0a, 0x99, 0x2b, 0xa8, 0xa7, 0x75, 0x91, 0x7e, 0x21, 0xf2, 0x41, 0x68,
+  0x63, 0x36, 0x57, 0xc8, 0x34, 0x2c, 0xc0, 0x66, 0xba, 0xea, 0x62, 0xf2, 0xab, 0x55, 0xf6, 0x23,
+  0x1c, 0x3f, 0xac, 0xe4, 0x6c, 0x19, 0x5e, 0x7a, 0xf1, 0x1b, 0x3c, 0xbf, 0x81, 0x2c, 0x1a, 0x36,
+  0x6d, 0xb9, 0x33, 0x43, 0x1b, 0xba, 0xf3, 0x88, 0xbf, 0xc7, 0xc2, 0x46, 0x4f, 0x0f, 0x33, 0xec,
+  0x8f, 0xe7, 0xdd, 0x68, 0x33, 0xef, 0x0a, 0x83, 0x1b, 0x3d, 0x41, 0x23, 0xbf, 0xe7, 0x31, 0x03,
+  0x0b, 0xe9, 0x54, 0xe9, 0x71, 0xd0, 0x94, 0x95, 0x09, 0x53, 0xe6, 0x94, 0x96, 0xb1, 0xe9, 0xa1,
+  0x72, 0xa5, 0xb0, 0x5f, 0xc3, 0x45, 0x79, 0x74, 0x3e, 0x24, 0xa1, 0x2a, 0x00, 0x1f, 0x9c, 0x57,
+  0x96, 0x87, 0x43, 0xc0, 0x01, 0x75, 0x51, 0xbf, 0xd1, 0xe9, 0x45, 0xb9, 0x1f, 0x9a, 0x10, 0xa8,
+  0x87, 0x8e, 0xff, 0xa4, 0xf0, 0x97, 0xb4, 0x74, 0x8d, 0x43, 0xf6, 0xee, 0xad, 0x97, 0x15, 0xe5,
+  0x1e, 0x0d, 0x14, 0x5f, 0xb3, 0x5a, 0x1c, 0xd7, 0x05, 0xd4, 0xfa, 0x73, 0xa7, 0x19, 0x93, 0xbe,
+  0x86, 0x69, 0x5a, 0x30, 0x0c, 0x02, 0x83, 0x11, 0x74, 0xe0, 0x81, 0xaf, 0x47, 0x82, 0x67, 0x9b,
+  0xca, 0x6c, 0x47, 0xbf, 0x43, 0x5b, 0xad, 0xe7, 0xdf, 0xa9, 0x6d, 0x38, 0x78, 0x0e, 0xaa, 0x06,
+  0xfb, 0x5d, 0xb2, 0xb7, 0xa9, 0x0d, 0x4f, 0xbd, 0x2b, 0xef, 0x1f, 0x52, 0xb7, 0x6a, 0x81, 0xfe,
+  0x55, 0x24, 0x0c, 0x4c, 0x18, 0xb3, 0x40, 0xe9, 0x7e, 0xab, 0x8d, 0xaf, 0x44, 0x35, 0x46, 0x03,
+  0x33, 0x92, 0x65, 0xff, 0xbf, 0x44, 0xd8, 0x1a, 0xe8, 0xa5, 0x66, 0xbd, 0x03, 0xa3, 0xe9, 0x8c,
+  0xc5, 0x55, 0x0c, 0xb3, 0x58, 0x04, 0x17, 0x07, 0x7f, 0xa0, 0xfe, 0x95, 0xd5, 0xba, 0xac, 0x80,
+  0x35, 0x95, 0x3c, 0x49, 0x57, 0xea, 0x54, 0x5d, 0xa7, 0x30, 0xe4, 0x42, 0xa0, 0x2f, 0x58, 0xfb,
+  0xac, 0x0c, 0xe8, 0xe7, 0x18, 0xad, 0x30, 0x8a, 0xad, 0x40, 0x48, 0xf2, 0x0d, 0x31, 0x66, 0x37,
+  0x2f, 0x23, 0x50, 0x91, 0xa7, 0xc0, 0x98, 0x24, 0xe0, 0x87, 0x6a, 0x72, 0x83, 0xa5, 0x8a, 0x3a,
+  0xb9, 0x59, 0x5f, 0x83, 0x95, 0xcc, 0x50, 0x48, 0x2a, 0x78, 0x6e, 0xac, 0x49, 0xdf, 0x8e, 0xc8,
+  0x93, 0xbe, 0x1d, 0xdc, 0x71, 0x48, 0x84, 0xaf, 0x90, 0xaf, 0x49, 0x10, 0xd3, 0x2c, 0x9b, 0xb6,
+  0x8b, 0xd1, 0x2a, 0x1f, 0xef, 0x21, 0x9d, 0xed, 0x96, 0xb9, 0xd3, 0xeb, 0x83, 0x3b, 0xc6, 0x71,
+  0xd8, 0x6c, 0x4d, 0xd2, 0xc3, 0x8f, 0x0c, 0xe6, 0x78, 0xc5, 0x97, 0x8c, 0x2c, 0x81, 0x4c, 0x09,
+  0x89, 0x81, 0x4f, 0x93, 0x90, 0x58, 0xf3, 0x91, 0x62, 0x6a, 0x99, 0xf4, 0xd3, 0x3a, 0x86, 0x4a,
+  0xc0, 0xa1, 0x36, 0xe3, 0x55, 0x28, 0x26, 0x66, 0xa7, 0x7d, 0xf8, 0x0f, 0xf8, 0x9c, 0xf4, 0xf5,
+  0x32, 0x8e, 0xfd, 0x26, 0x32, 0x79, 0x98, 0x6f, 0xb7, 0x26, 0x22, 0xc5, 0x8a, 0x45, 0x74, 0x47,
+  0x9d, 0xb6, 0x0d, 0x03, 0x19, 0x4c, 0xfa, 0x66, 0x1d, 0xcf, 0x6f, 0x98, 0xf0, 0x0a, 0xf4, 0xe6,
+  0x06, 0x61, 0xb2, 0x8e, 0xa3, 0x40, 0xd8, 0x6e, 0xd8, 0xc8, 0x2e, 0x45, 0x4f, 0x0f, 0x4f, 0x20,
+  0xb2, 0x99, 0x84, 0x9c, 0x93, 0x80, 0x08, 0xee, 0x6b, 0x74, 0x5a, 0x7f, 0xfb, 0x70, 0x92, 0xa5,
+  0x34, 0xd1, 0xf8, 0x30, 0x0f, 0xda, 0x87, 0xbd, 0x1e, 0xe8, 0x87, 0x25, 0xbb, 0x61, 0x89, 0xb1,
+  0x55, 0xb7, 0x0f, 0xff, 0xfb, 0x9f, 0xa3, 0x7c, 0x33, 0x47, 0x66, 0xbe, 0xb6, 0xab, 0x7f, 0xbb,
+  0x5a, 0xf2, 0x90, 0xab, 0xeb, 0x07, 0xe8, 0x8e, 0x56, 0xcb, 0xbb, 0x55, 0x3f, 0xf9, 0x16, 0xc5,
+  0xe9, 0x5b, 0xf2, 0x9e, 0xad, 0x59, 0xbc, 0x4b, 0xb1, 0x56, 0x99, 0x46, 0x46, 0xe3, 0x03, 0xe4,
+  0x7d, 0x64, 0xf0, 0x3c, 0xb2, 0x16, 0x5c, 0x92, 0xcf, 0x58, 0x22, 0x1e, 0x62, 0x4c, 0xb9, 0xbe,
+  0xfb, 0x3c, 0xef, 0xbf, 0xe5, 0x3c, 0xef, 0xb1, 0x1c, 0x92, 0x77, 0xf8, 0x68, 0x9a, 0x3d, 0xcc,
+  0x9e, 0x31, 0xbf, 0x5b, 0x7d, 0xbc, 0xba, 0xda, 0x0e, 0x60, 0x13, 0x47, 0x6d, 0x70, 0xd1, 0x80,
+  0x86, 0x87, 0x26, 0x9b, 0xc8, 0x27, 0xbd, 0x06, 0x70, 0x86, 0x0d, 0x96, 0x72, 0xf8, 0x68, 0x6f,
+  0xdd, 0xd1, 0x67, 0xd3, 0x40, 0x97, 0x3c, 0x53, 0xd8, 0x52, 0x4a, 0xf1, 0x9b, 0xd4, 0xd8, 0x9d,
+  0xda, 0x05, 0xd0, 0xea, 0x61, 0x2a, 0x0d, 0xa5, 0x7d, 0xf8, 0x37, 0x23, 0xca, 0xa6, 0x3a, 0x79,
+  0x17, 0xc6, 0xcc, 0x9e, 0x71, 0xeb, 0xb1, 0x9a, 0x48, 0xa4, 0x80, 0x15, 0x48, 0xc0, 0x1f, 0x01,
+  0xe5, 0xa3, 0x95, 0xf5, 0xbd, 0x58, 0xd2, 0xe8, 0x47, 0xa0, 0x80, 0x34, 0x28, 0x1d, 0x35, 0xdb,
+  0x44, 0xf0, 0x6d, 0x2e, 0x67, 0x4a, 0x17, 0xeb, 0x2d, 0xee, 0xce, 0xfb, 0x6b, 0x7b, 0xeb, 0xb2,
+  0xee, 0x44, 0x8d, 0x4a, 0x19, 0x63, 0x40, 0x9f, 0x44, 0x92, 0x65, 0x91, 0x88, 0x21, 0x46, 0x4c,
+  0x80, 0x17, 0x0b, 0x65, 0xf9, 0xd4, 0x0d, 0x8c, 0x54, 0x1b, 0x98, 0x0d, 0xef, 0x1a, 0x3f, 0xf6,
+  0xe7, 0x69, 0xdb, 0x87, 0x6f, 0x7a, 0x35, 0x6d, 0x3f, 0xf3, 0xf7, 0x47, 0xed, 0xbc, 0xbc, 0xc2,
+  0x43, 0xb7, 0x7e, 0x4d, 0x53, 0xc9, 0x8c, 0x2a, 0xeb, 0x67, 0x93, 0x38, 0x48, 0x75, 0x87, 0x7f,
+  0xee, 0x38, 0x49, 0xfa, 0xf6, 0x04, 0x7a, 0x31, 0x33, 0xd6, 0x36, 0x97, 0xf7, 0xa2, 0x2f, 0x78,
+  0x0c, 0xee, 0x91, 0x37, 0xb2, 0xc8, 0xf7, 0xf0, 0x0a, 0x4c, 0x9f, 0xc2, 0x61, 0xbc, 0x41, 0x71,
+  0x86, 0x3d, 0xaf, 0x7e, 0x84, 0x9c, 0xdf, 0x82, 0x87, 0xed, 0xef, 0xc3, 0xbe, 0x4e, 0xc3, 0xf7,
+  0xe2, 0xb2, 0x7d, 0xf8, 0xf9, 0xf8, 0x15, 0x81, 0x0b, 0xe2, 0x5e, 0x1c, 0xd3, 0xce, 0xbd, 0xe8,
+  0x2d, 0x97, 0xb5, 0xb9, 0xf7, 0xcc, 0x62, 0x1f, 0x78, 0x7b, 0x25, 0x76, 0xbf, 0x74, 0x00, 0x8c,
+  0x34, 0x35, 0xf0, 0x86, 0xdd, 0x42, 0x87, 0xcd, 0xef, 0x86, 0xfe, 0x16, 0x1c, 0x69, 0xb0, 0xe3,
+  0xd5, 0xc3, 0xc1, 0x6b, 0xbe, 0x87, 0xa2, 0x87, 0xe7, 0xb2, 0x26, 0x7a, 0xe4, 0xb7, 0xf0, 0x61,
+  0xf7, 0x1b, 0xe0, 0xdb, 0x41, 0x4b, 0xd7, 0x1a, 0x68, 0x28, 0xea, 0xf8, 0xed, 0x1b, 0xba, 0x8a,
+  0xb1, 0x5a, 0xe0, 0x1d, 0x81, 0xf8, 0xd1, 0xf7, 0x93, 0xbe, 0x21, 0xdc, 0x95, 0xa7, 0x79, 0xd6,
+  0x07, 0x92, 0xa7, 0x30, 0x23, 0x80, 0x96, 0x4c, 0x11, 0x4c, 0x55, 0x46, 0xa6, 0xe4, 0xe6, 0xf6,
+  0xa0, 0x15, 0x83, 0x30, 0x9c, 0x35, 0xe0, 0xd6, 0x71, 0x0e, 0x2c, 0xc1, 0x9c, 0xb3, 0x38, 0x84,
+  0x15, 0x37, 0xa4, 0x8a, 0x76, 0xc9, 0x05, 0xbb, 0xee, 0x90, 0xe9, 0x21, 0xc1, 0xbb, 0x53, 0x4d,
+  0xfc, 0x67, 0x72, 0x8e, 0xdf, 0x8f, 0x6f, 0xf0, 0xf3, 0xd6, 0x7b, 0x7c, 0x03, 0x24, 0xb7, 0xe7,
+  0x64, 0x8c, 0xa4, 0x67, 0xb9, 0x94, 0x55, 0x0a, 0x0c, 0x0c, 0x07, 0x96, 0x2c, 0x97, 0xa5, 0xc5,
+  0xdc, 0xe4, 0x30, 0xcc, 0xb4, 0x33, 0x25, 0xa1, 0x08, 0xa0, 0x4f, 0x26, 0xca, 0x83, 0x30, 0x7d,
+  0x1d, 0x33, 0xbc, 0xfc, 0xcb, 0xf5, 0xbb, 0xd0, 0x75, 0x50, 0xba, 0xd3, 0xc1, 0xa1, 0x57, 0x12,
+  0xd7, 0x30, 0x81, 0x02, 0x22, 0xe6, 0xe4, 0xc3, 0xec, 0x0b, 0xf0, 0x7a, 0x70, 0x97, 0x19, 0xc1,
+  0x9d, 0x42, 0xec, 0x92, 0xaa, 0x20, 0x02, 0xa9, 0xb0, 0xe7, 0xe9, 0x6b, 0xb7, 0xff, 0x2f, 0x14,
+  0xe4, 0x7a, 0x3f, 0x77, 0xfe, 0xe9, 0x55, 0xa6, 0x9c, 0xc7, 0x7d, 0x10, 0xcd, 0xe7, 0xc4, 0x35,
+  0x1c, 0x3f, 0xfd, 0x44, 0x1e, 0x19, 0x48, 0xde, 0xbf, 0x57, 0x4c, 0x5e, 0x7f, 0xd2, 0xd7, 0x42,
+  0xba, 0xe7, 0x66, 0xd6, 0x3a, 0xb5, 0x5e, 0x7e, 0x7c, 0xa3, 0xe9, 0x4f, 0x07, 0x67, 0xb7, 0xed,
+  0xb3, 0x73, 0xad, 0xd8, 0xb2, 0xc1, 0x38, 0xeb, 0x26, 0xec, 0x92, 0x7c, 0xd0, 0xf4, 0xee, 0xb9,
+  0x9e, 0xd5, 0x2a, 0xe4, 0xe7, 0x5d, 0x92, 0x5f, 0x77, 0xf4, 0xf3, 0x08, 0xfc, 0xcb, 0x8d, 0x25,
+  0x59, 0x82, 0xf3, 0x69, 0xdd, 0x4e, 0x15, 0x0b, 0x9a, 0xe5, 0xba, 0x69, 0x75, 0x60, 0x21, 0x0b,
+  0x0f, 0xbb, 0x26, 0x06, 0x6b, 0xf6, 0x65, 0xc6, 0x94, 0x77, 0x18, 0x98, 0x87, 0xd6, 0x02, 0x96,
+  0xb4, 0x93, 0xf3, 0x78, 0xd8, 0x13, 0x8e, 0xcc, 0xeb, 0x6d, 0xe0, 0xd7, 0xb2, 0x0f, 0x4a, 0xb0,
+  0xf8, 0x34, 0x4c, 0x71, 0xc3, 0xd5, 0x3b, 0x5d, 0x12, 0xf2, 0x05, 0x57, 0x19, 0x6a, 0x6f, 0x61,
+  0x16, 0x81, 0x83, 0xcc, 0x2b, 0xa0, 0xe9, 0x14, 0xc2, 0x2a, 0x59, 0x2d, 0x67, 0x4c, 0x3a, 0x10,
+  0x34, 0x7a, 0xd1, 0x53, 0xe2, 0x0d, 0xbf, 0x62, 0xa1, 0x9b, 0x33, 0x8d, 0x89, 0xd3, 0xeb, 0x41,
+  0xec, 0x55, 0x0e, 0xe5, 0x3a, 0x38, 0x5f, 0x3a, 0x5d, 0xab, 0xc9, 0xd5, 0x01, 0x69, 0xa3, 0xd1,
+  0xa9, 0xb8, 0xd0, 0xe9, 0xc0, 0x03, 0x16, 0xda, 0xb2, 0xc6, 0x0b, 0xf3, 0xe1, 0x0e, 0xd6, 0x7c,
+  0xc8, 0xdc, 0xce, 0x97, 0x46, 0x3b, 0xd8, 0xd2, 0xb7, 0xc8, 0x30, 0xdc, 0x60, 0x90, 0xeb, 0x1d,
+  0x0c, 0xc5, 0x0c, 0x68, 0x46, 0xc0, 0xed, 0xea, 0x62, 0xbe, 0x83, 0x5b, 0x37, 0xb8, 0x62, 0x80,
+  0x43, 0x66, 0xbf, 0xd3, 0x70, 0xbd, 0x19, 0xa6, 0x72, 0xdf, 0xf3, 0xec, 0xa5, 0x7e, 0xf6, 0xef,
+  0x12, 0xf4, 0x1b, 0xde, 0xff, 0x6a, 0x1e, 0xbe, 0x6b, 0xf1, 0xa0, 0x5f, 0xbb, 0x3c, 0x20, 0x18,
+  0x90, 0xae, 0x4c, 0x27, 0xfd, 0x5e, 0x63, 0xaa, 0x99, 0x1b, 0x79, 0xe1, 0x54, 0x5f, 0x08, 0x38,
+  0x05, 0x40, 0x84, 0xf0, 0x3a, 0xbe, 0x87, 0x05, 0x89, 0x90, 0x45, 0xbf, 0x4b, 0xd0, 0x25, 0xf0,
+  0x17, 0xba, 0xd4, 0x45, 0xa8, 0xfa, 0x3a, 0xc5, 0x21, 0x3f, 0xc3, 0x01, 0xf3, 0xc3, 0x40, 0x00,
+  0x39, 0xf6, 0xa5, 0x82, 0x03, 0x41, 0x93, 0x1f, 0x1a, 0x97, 0xcd, 0xab, 0x0f, 0x5c, 0x75, 0x50,
+  0xaa, 0x81, 0xd0, 0x08, 0x62, 0xbc, 0x3b, 0xa8, 0xa6, 0x1c, 0xcf, 0xf2, 0x21, 0x70, 0x4a, 0x6a,
+  0xf6, 0x2f, 0x36, 0x9c, 0xc2, 0x65, 0xc6, 0xde, 0xae, 0x53, 0x9f, 0x40, 0x9d, 0x6e, 0xab, 0xa0,
+  0xad, 0x5c, 0x22, 0xa2, 0xc6, 0x7c, 0xf9, 0xb2, 0x04, 0xb8, 0x65, 0xf2, 0x74, 0x5a, 0x9d, 0x12,
+  0x94, 0x19, 0x07, 0xb7, 0xa1, 0xca, 0x77, 0x36, 0x61, 0x35, 0xc6, 0x51, 0x8d, 0x2b, 0xa7, 0xae,
+  0x5e, 0x23, 0x32, 0xab, 0xb7, 0x10, 0x86, 0x98, 0xb6, 0x8d, 0xa0, 0x15, 0x50, 0x69, 0x64, 0x14,
+  0x9d, 0xe0, 0xbb, 0x18, 0xe8, 0x1b, 0x2d, 0xf4, 0x12, 0xcc, 0x88, 0xce, 0x18, 0x73, 0xa3, 0x3e,
+  0x37, 0x82, 0x6e, 0x87, 0x86, 0x5f, 0x56, 0xc6, 0x80, 0x86, 0xe0, 0xa5, 0xbe, 0xd7, 0xc5, 0x88,
+  0x27, 0xe4, 0x58, 0x8a, 0x05, 0xf4, 0x34, 0x44, 0xe9, 0x04, 0x62, 0x99, 0x42, 0x0b, 0x62, 0xe1,
+  0x26, 0xe5, 0x91, 0xdd, 0x42, 0xb2, 0x39, 0xf6, 0x3a, 0x4b, 0xf2, 0x4a, 0x64, 0xda, 0x7c, 0x4a,
+  0xa4, 0x29, 0x0b, 0xc7, 0xe4, 0x28, 0x62, 0xc1, 0x05, 0x0a, 0x9d, 0x41, 0xfc, 0x9f, 0x44, 0x2c,
+  0x21, 0xba, 0x45, 0x3a, 0xa5, 0xa3, 0x73, 0xf8, 0x4d, 0x8b, 0xe6, 0xeb, 0x9b, 0xf6, 0x2c, 0x46,
+  0x6a, 0x50, 0x5e, 0x70, 0x3f, 0x9a, 0x9a, 0xf0, 0x34, 0x87, 0xac, 0xda, 0xe4, 0x34, 0xbf, 0x39,
+  0x23, 0xbf, 0xff, 0xbe, 0xd5, 0x24, 0x25, 0x04, 0x14, 0x62, 0x8e, 0x83, 0xf6, 0xbd, 0x6d, 0xa4,
+  0x35, 0xa4, 0xbc, 0x90, 0xaf, 0x00, 0x1e, 0x60, 0xa5, 0xd9, 0x75, 0x12, 0x10, 0xd7, 0xe6, 0xb0,
+  0x92, 0xd7, 0x45, 0x4e, 0x82, 0xf5, 0x52, 0xb8, 0xc0, 0x7c, 0xa1, 0x97, 0x94, 0x43, 0x41, 0x66,
+  0xd8, 0xe7, 0x9c, 0x3e, 0x1e, 0x0c, 0x4f, 0x63, 0xdb, 0x23, 0xa4, 0x15, 0x5f, 0x24, 0xae, 0xee,
+  0xf7, 0x5d, 0x4b, 0x9a, 0xf3, 0x7a, 0x5f, 0x32, 0xe8, 0x51, 0x58, 0x57, 0x4c, 0xeb, 0x31, 0x54,
+  0x08, 0x09, 0x12, 0x17, 0xfb, 0xa1, 0xcb, 0xa4, 0x14, 0x32, 0x2f, 0x04, 0x22, 0x66, 0x9e, 0x5e,
+  0x70, 0x9d, 0xd7, 0xf8, 0x65, 0x54, 0xa2, 0x23, 0x32, 0x8d, 0x59, 0x0f, 0x07, 0x63, 0x28, 0x68,
+  0x86, 0xab, 0x96, 0x68, 0xe6, 0x6c, 0xf9, 0xcb, 0x95, 0xa9, 0x6e, 0xe5, 0x78, 0xb9, 0xad, 0x69,
+  0xe9, 0xdf, 0xfa, 0x20, 0xc4, 0xc8, 0xa9, 0x25, 0x3a, 0x1b, 0xdb, 0x5e, 0x72, 0x6b, 0xaa, 0x13,
+  0xb6, 0xf2, 0x8e, 0x26, 0xf3, 0xec, 0xdc, 0xf2, 0x55, 0xbf, 0x4c, 0xca, 0x4d, 0x60, 0xd9, 0x00,
+  0xc9, 0x4d, 0x6b, 0xc9, 0x54, 0x24, 0x20, 0x44, 0x9c, 0xe3, 0x0f, 0x9f, 0x4e, 0xc0, 0x0b, 0xe6,
+  0xcd, 0x48, 0x36, 0x06, 0xf1, 0x8e, 0x2d, 0x0c, 0xbd, 0x13, 0xe8, 0x57, 0x18, 0x59, 0x34, 0x4d,
+  0x63, 0x1e, 0xe8, 0x2c, 0xe8, 0xa3, 0x69, 0x1c, 0x72, 0xdb, 0xd5, 0xbf, 0x3c, 0x8e, 0xc9, 0x5f,
+  0x3f, 0x7d, 0xf8, 0x05, 0x0a, 0x17, 0xbe, 0xf6, 0xe1, 0xf3, 0x6b, 0x17, 0x17, 0x3b, 0xad, 0xdb,
+  0x8e, 0xa7, 0xed, 0xe4, 0xe6, 0x76, 0x82, 0x43, 0x6c, 0x35, 0x14, 0xd8, 0x27, 0x34, 0x76, 0x32,
+  0xcf, 0x44, 0xa5, 0x91, 0x8c, 0xff, 0x2b, 0xc3, 0x0d, 0x0f, 0x71, 0xb6, 0x39, 0x75, 0xea, 0x8f,
+  0x1d, 0x8e, 0xee, 0x40, 0x66, 0x8a, 0xc7, 0x6b, 0x33, 0x14, 0xdb, 0x2b, 0x1c, 0x30, 0x9d, 0xb3,
+  0xb2, 0x5c, 0x67, 0x31, 0x37, 0x73, 0xc4, 0x9d, 0x65, 0xde, 0x50, 0xe1, 0xc0, 0xf2, 0x7a, 0x0d,
+  0x1b, 0xef, 0xa1, 0x24, 0xb1, 0x04, 0x62, 0xc0, 0xd1, 0x93, 0x30, 0x88, 0xce, 0xa3, 0x6e, 0xb7,
+  0x14, 0x28, 0xcd, 0x8e, 0x6e, 0x64, 0x4e, 0xa7, 0x51, 0x68, 0xad, 0xf0, 0x7c, 0x68, 0xb8, 0x4b,
+  0x5d, 0x10, 0xe1, 0xb4, 0x5d, 0xe8, 0xab, 0x05, 0x8a, 0xee, 0x6c, 0x55, 0x59, 0x66, 0x66, 0xda,
+  0x39, 0x2c, 0x56, 0xc7, 0x64, 0xc0, 0xb4, 0x45, 0x19, 0xf8, 0xf7, 0x62, 0x87, 0xae, 0x3a, 0x37,
+  0xf4, 0x51, 0x69, 0xf4, 0xdd, 0x33, 0x9a, 0xde, 0x79, 0x24, 0xb6, 0xd6, 0x23, 0x95, 0xb6, 0xa3,
+  0x0d, 0x55, 0xbd, 0xe4, 0x29, 0xed, 0xca, 0xdc, 0x40, 0xcd, 0xf4, 0xeb, 0x98, 0xa1, 0x3c, 0x15,
+  0x71, 0x7c, 0xc2, 0x97, 0xda, 0x97, 0xc9, 0x2a, 0x8e, 0x0f, 0xca, 0xe1, 0x5d, 0xaa, 0x63, 0xd8,
+  0x34, 0x2d, 0x22, 0x77, 0x14, 0xa6, 0x46, 0xc1, 0xd2, 0x81, 0x2c, 0x87, 0xf1, 0x28, 0x29, 0xca,
+  0x5a, 0x51, 0x56, 0x5c, 0x90, 0x5e, 0x95, 0x0c, 0x87, 0xc6, 0x41, 0x43, 0x02, 0x16, 0xb7, 0x49,
+  0x0b, 0x13, 0x0f, 0x3c, 0xe9, 0x56, 0x8b, 0x54, 0x06, 0x35, 0x77, 0x53, 0x75, 0x10, 0x33, 0x2a,
+  0x0b, 0x29, 0x25, 0x88, 0xba, 0x26, 0x73, 0x86, 0x42, 0x14, 0x7c, 0x26, 0x50, 0xa2, 0x8e, 0x57,
+  0x59, 0x54, 0x15, 0x65, 0xd4, 0x88, 0xe0, 0x82, 0x61, 0x24, 0xe1, 0x30, 0xfd, 0x2b, 0x9b, 0x7d,
+  0xd2, 0xf7, 0xee, 0xf9, 0x65, 0x36, 0xee, 0xf7, 0x1f, 0xdf, 0xc4, 0xc2, 0xa4, 0xa9, 0x17, 0x89,
+  0x4c, 0xe1, 0xdf, 0x64, 0xdc, 0x8e, 0x5f, 0x0c, 0xfa, 0xe7, 0x18, 0x67, 0x9a, 0xd0, 0x13, 0x89,
+  0x48, 0x19, 0x0e, 0x2d, 0x15, 0xbc, 0x95, 0xcd, 0x25, 0xf4, 0x1e, 0xba, 0xd0, 0x83, 0x73, 0xd5,
+  0x45, 0x5b, 0x6b, 0xa6, 0x4e, 0xfd, 0x14, 0xff, 0x1a, 0xc4, 0xd0, 0x7a, 0xe6, 0x61, 0x63, 0xd3,
+  0x6b, 0x15, 0xf9, 0x41, 0x2c, 0x74, 0x69, 0xce, 0x0f, 0x55, 0xf5, 0x18, 0xda, 0x1f, 0x6c, 0x8e,
+  0x46, 0x11, 0x2b, 0xe5, 0x56, 0xac, 0xd0, 0xc5, 0x1f, 0x30, 0xac, 0xb5, 0x51, 0x5a, 0x83, 0xa9,
+  0x42, 0x89, 0xb7, 0xf0, 0x24, 0x69, 0x1f, 0xe9, 0xe0, 0x09, 0xd0, 0xbc, 0xf9, 0xee, 0xeb, 0xbf,
+  0x6c, 0xf9, 0x1f, 0x8d, 0x9d, 0xab, 0x0a, 0xe9, 0x22, 0x00, 0x00,
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef ESP32_ZONES_H
+#define ESP32_ZONES_H
+
+#include <Arduino.h>
+#include "zone.h"
+
+// Zone profiles for the ESP32-S3 (see control_core.h and zone.h). The LDR
+// used to be on GPIO2 together with the VPD relay; it is on GPIO8 (ADC1_CH7)
+// now. Zone 1's stepper moved from GPIO9/10 to GPIO11/12 so zone 2's pH and
+// LDR get ADC1 pins.
+struct Zone1Board {
+  static constexpr uint8_t phPin = 1;   // ADC1_CH0
+  static constexpr uint8_t ldrPin = 8;  // ADC1_CH7
+  static constexpr uint8_t vpdRelay = 2;
+  static constexpr uint8_t acidRelay = 3;
+  static constexpr uint8_t baseRelay = 4;
+  static constexpr uint8_t mixRelay = 5;
+  static constexpr uint8_t trigPin = 6;
+  static constexpr uint8_t echoPin = 7;
+  static constexpr uint8_t stepPin = 11;
+  static constexpr uint8_t dirPin = 12;
+  static constexpr uint8_t sdaPin = 41;
+  static constexpr uint8_t sclPin = 42;
+  static constexpr uint8_t sht31Address = 0x44;
+  static constexpr uint8_t i2cMuxChannel = NO_MUX;
+  static constexpr uint16_t adcMax = 4095;  // 12-bit ADC
+  static constexpr float pHAtZero = 0.0;
+  static constexpr float pHAtFullScale = 14.0;
+  static constexpr bool digitalLight = false;
+  static constexpr int defaultLightThreshold = 2000;
+  static constexpr float reservoirRadius = 20.0;
+  static constexpr float reservoirHeight = 35.0;
+};
+
+// Same probes and tank as zone 1; the SHT31 has ADDR pulled high
+struct Zone2Board : Zone1Board {
+  static constexpr uint8_t phPin = 9;    // ADC1_CH8
+  static constexpr uint8_t ldrPin = 10;  // ADC1_CH9
+  static constexpr uint8_t vpdRelay = 13;
+  static constexpr uint8_t acidRelay = 14;
+  static constexpr uint8_t baseRelay = 15;
+  static constexpr uint8_t mixRelay = 16;
+  static constexpr uint8_t trigPin = 17;
+  static constexpr uint8_t echoPin = 18;
+  static constexpr uint8_t stepPin = 21;
+  static constexpr uint8_t dirPin = 38;
+  static constexpr uint8_t sht31Address = 0x45;
+};
+
+static_assert(Zone1Board::phPin <= 10 && Zone1Board::ldrPin <= 10 && Zone2Board::phPin <= 10 &&
+                  Zone2Board::ldrPin <= 10,
+              "Continuous ADC needs ADC1 pins (GPIO1-10)");
+static_assert(zonesApart<Zone1Board, Zone2Board>(), "Zones 1 and 2 share a pin or an SHT31 address");
+
+#endif
@@ -0,0 +1,137 @@
+// Decoder for the batched uplink frames from esp32/sensor_monitor. The
+// format is documented in esp32/sensor_monitor/uplink_batch.h: a 6-byte
+// header, then Gorilla-style delta-of-delta timestamps and XOR-compressed
+// float values, MSB first. Batches replayed from the device's flash queue
+// arrive several to a bundle (esp32/sensor_monitor/uplink_queue.h). Both
+// travel base64 in socket.io text events.
+
+export const UPLINK_FORMAT_VERSION = 1;
+export const UPLINK_BUNDLE_VERSION = 2;
+const HEADER_SIZE = 6;
+const RECORD_HEADER_SIZE = 6;
+
+export interface UplinkSample {
+  deviceTime: number; // ms since the device booted
+  values: number[];
+}
+
+// A batch replayed from the device's flash queue (uplink_queue.h)
+export interface QueuedBatch {
+  unixTime: number; // Seconds since 1970 of the newest sample, 0 if the device could not date it
+  frame: Uint8Array;
+}
+
+class BitReader {
+  private position: number;
+
+  constructor(private bytes: Uint8Array, start: number) {
+    this.position = start * 8;
+  }
+
+  // Up to 32 bits as an unsigned number
+  read(n: number): number {
+    let value = 0;
+    for (let i = 0; i < n; i++) {
+      const byte = this.bytes[this.position >> 3];
+      if (byte === undefined) {
+        throw new Error('Uplink frame truncated');
+      }
+      value = value * 2 + ((byte >> (7 - (this.position & 7))) & 1);
+      this.position++;
+    }
+    return value;
+  }
+
+  // n bits as a two's complement number
+  readSigned(n: number): number {
+    const value = this.read(n);
+    return value >= 2 ** (n - 1) ? value - 2 ** n : value;
+  }
+}
+
+const floatView = new DataView(new ArrayBuffer(4));
+
+function bitsToFloat(bits: number): number {
+  floatView.setUint32(0, bits >>> 0);
+  return floatView.getFloat32(0);
+}
+
+function readTimestampDod(reader: BitReader): number {
+  if (reader.read(1) === 0) return 0;
+  if (reader.read(1) === 0) return reader.readSigned(7);
+  if (reader.read(1) === 0) return reader.readSigned(9);
+  if (reader.read(1) === 0) return reader.readSigned(12);
+  return reader.readSigned(32);
+}
+
+interface Channel {
+  bits: number;
+  leading: number;
+  trailing: number;
+}
+
+function readValue(reader: BitReader, channel: Channel): void {
+  if (reader.read(1) === 0) return;
+  if (reader.read(1) === 1) {
+    channel.leading = reader.read(5);
+    const length = reader.read(5) + 1;
+    channel.trailing = 32 - channel.leading - length;
+  }
+  const length = 32 - channel.leading - channel.trailing;
+  const meaningful = reader.read(length);
+  channel.bits = (channel.bits ^ (meaningful * 2 ** channel.trailing)) >>> 0;
+}
+
+// Decode one frame with `channels` values per sample
+export function decodeUplinkBatch(frame: Uint8Array, channels: number): UplinkSample[] {
+  if (frame.length < HEADER_SIZE || frame[0] !== UPLINK_FORMAT_VERSION) {
+    throw new Error('Not an uplink batch frame');
+  }
+  const count = frame[1];
+  let time = (frame[2] | (frame[3] << 8) | (frame[4] << 16) | (frame[5] << 24)) >>> 0;
+  const reader = new BitReader(frame, HEADER_SIZE);
+  const state: Channel[] = [];
+  const samples: UplinkSample[] = [];
+  let delta = 0;
+
+  for (let i = 0; i < count; i++) {
+    if (i === 0) {
+      for (let c = 0; c < channels; c++) {
+        state.push({ bits: reader.read(32), leading: 32, trailing: 0 });
+      }
+    } else {
+      delta = (delta + readTimestampDod(reader)) >>> 0;
+      time = (time + delta) >>> 0;
+      state.forEach(channel => readValue(reader, channel));
+    }
+    samples.push({ deviceTime: time, values: state.map(channel => bitsToFloat(channel.bits)) });
+  }
+  return samples;
+}
+
+// Split a replay bundle into the batches it carries
+export function splitUplinkBundle(bundle: Uint8Array): QueuedBatch[] {
+  if (bundle.length < 1 || bundle[0] !== UPLINK_BUNDLE_VERSION) {
+    throw new Error('Not an uplink bundle');
+  }
+  const batches: QueuedBatch[] = [];
+  let position = 1;
+  while (position + RECORD_HEADER_SIZE <= bundle.length) {
+    const length = bundle[position] | (bundle[position + 1] << 8);
+    const unixTime =
+      (bundle[position + 2] | (bundle[position + 3] << 8) | (bundle[position + 4] << 16) | (bundle[position + 5] << 24)) >>> 0;
+    const start = position + RECORD_HEADER_SIZE;
+    if (start + length > bundle.length) {
+      throw new Error('Uplink bundle truncated');
+    }
+    batches.push({ unixTime, frame: bundle.subarray(start, start + length) });
+    position = start + length;
+  }
+  return batches;
+}
+
+// Date a batch's samples back from the time of its newest one, in ms
+export function sampleDates(samples: UplinkSample[], newestTime: number): Date[] {
+  const newest = samples.length > 0 ? samples[samples.length - 1].deviceTime : 0;
+  return samples.map(sample => new Date(newestTime - ((newest - sample.deviceTime) >>> 0)));
+}
@@ -2,6 +2,7 @@ import { Server as SocketIOServer } from 'socket.io';
 import { NextApiRequest, NextApiResponse } from 'next';
 import dbConnect from '@/lib/mongodb';
 import Reading from '@/models/Reading';
+import { decodeUplinkBatch, sampleDates, splitUplinkBundle } from '@/lib/uplink';
 
 interface CustomResponse extends NextApiResponse {
   socket: {
@@ -34,6 +35,59 @@ const SocketHandler = async (req: NextApiRequest, res: CustomResponse) => {
         console.error('Error saving reading:', error);
       }
     });
+
+    // A live batch of samples, base64 in a text event (the device's
+    // socket.io client has no binary events). Device times are ms since
+    // boot, so samples are dated back from the batch's arrival.
+    socket.on('sensorBatch', async (data: string) => {
+      try {
+        const received = Date.now();
+        const samples = decodeUplinkBatch(Buffer.from(data, 'base64'), 2);
+        const dates = sampleDates(samples, received);
+        const readings = samples.map((sample, i) => ({
+          temperature: sample.values[0],
+          humidity: sample.values[1],
+          timestamp: dates[i],
+        }));
+        if (readings.length === 0) return;
+        await Reading.insertMany(readings);
+        readings.forEach(reading => io.emit('newReading', reading));
+      } catch (error) {
+        console.error('Error saving batch:', error);
+      }
+    });
+
+    // A bundle of batches replayed from the device's flash queue, each dated
+    // by the device. The ack tells the device it may delete them; without it
+    // the bundle comes again, so an error here loses nothing. Batches the
+    // device could not date are dropped: dating them from their arrival
+    // would file hours of backlog under "now".
+    socket.on('sensorBundle', async (sequence: number, data: string) => {
+      try {
+        const batches = splitUplinkBundle(Buffer.from(data, 'base64'));
+        const dated = batches.filter(batch => batch.unixTime > 0);
+        if (dated.length < batches.length) {
+          console.warn(`Dropped ${batches.length - dated.length} undated queued batches`);
+        }
+        const readings = dated.flatMap(batch => {
+          const samples = decodeUplinkBatch(batch.frame, 2);
+          const dates = sampleDates(samples, batch.unixTime * 1000);
+          return samples.map((sample, i) => ({
+            temperature: sample.values[0],
+            humidity: sample.values[1],
+            timestamp: dates[i],
+          }));
+        });
+        // Not pushed to the dashboard: a backlog would flood its
+        // 50-reading window with old data
+        if (readings.length > 0) {
+          await Reading.insertMany(readings);
+        }
+        socket.emit('bundleAck', sequence);
+      } catch (error) {
+        console.error('Error saving bundle:', error);
+      }
+    });
   });
 
   res.end();
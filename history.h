@@ -0,0 +1,252 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+
+// Fixed-memory sensor history for the dashboards.
+//
+// The caller hands begin() a buffer (PSRAM on boards that have it), which is
+// carved into HISTORY_BLOCK_SIZE blocks used as a ring: when the newest block
+// is full the oldest one is overwritten. Within a block each sample is stored
+// as the seconds since the previous sample plus, per channel, the change from
+// the previous sample, all as zigzag varints. Values are quantized to the
+// precision the dashboard shows first, so at 1 Hz a typical sample costs about
+// 7 bytes and an hour about 25 KB.
+//
+// Every block starts from zero, so a block can be decoded on its own and the
+// headers (start/end time) are enough to skip straight to a range.
+//
+// Not thread-safe; the owner serializes append() and read().
+
+#define HISTORY_BLOCK_SIZE 512
+#define HISTORY_CHANNELS 6
+#define HISTORY_MISSING INT32_MIN  // Quantized stand-in for a failed (NaN) reading
+
+// One decoded sample. All fields are 4 bytes so the struct can be streamed as-is
+struct HistorySample {
+  uint32_t time;  // Seconds since boot
+  float temperature;
+  float humidity;
+  float vpd;
+  float pH;
+  float reservoirVolume;
+  float lightIntensity;
+};
+static_assert(sizeof(HistorySample) == 4 * (HISTORY_CHANNELS + 1), "HistorySample must stay unpadded");
+
+class SensorHistory {
+public:
+  void begin(uint8_t* buffer, size_t size) {
+    arena = buffer;
+    blockCount = buffer != NULL ? size / HISTORY_BLOCK_SIZE : 0;
+    head = 0;
+    filled = 0;
+  }
+
+  size_t capacityBytes() const {
+    return blockCount * HISTORY_BLOCK_SIZE;
+  }
+
+  bool empty() const {
+    return filled == 0;
+  }
+
+  uint32_t oldestTime() const {
+    return empty() ? 0 : header(blockAt(0)).startTime;
+  }
+
+  uint32_t newestTime() const {
+    return empty() ? 0 : header(head).endTime;
+  }
+
+  // Add a sample. Times must not go backwards; such samples are dropped.
+  void append(const HistorySample& sample) {
+    if (blockCount == 0 || (!empty() && sample.time < header(head).endTime)) {
+      return;
+    }
+
+    int32_t values[HISTORY_CHANNELS];
+    quantize(sample, values);
+
+    uint8_t record[MAX_RECORD_SIZE];
+    size_t length = 0;
+    if (!empty()) {
+      const BlockHeader& current = header(head);
+      length = encode(record, sample.time - current.endTime, values, lastValues);
+      if (current.used + length > HISTORY_BLOCK_SIZE) {
+        length = 0;
+      }
+    }
+    if (length == 0) {
+      startBlock(sample.time);
+      const int32_t zero[HISTORY_CHANNELS] = {0};
+      length = encode(record, 0, values, zero);
+    }
+
+    BlockHeader& current = header(head);
+    memcpy(block(head) + current.used, record, length);
+    current.used += length;
+    current.count++;
+    current.endTime = sample.time;
+    memcpy(lastValues, values, sizeof(lastValues));
+  }
+
+  // Decode up to `maxSamples` samples with from <= time <= to into `out`,
+  // keeping only samples at least `step` seconds apart. Returns how many were
+  // written; to page through a long range, call again with `from` set to the
+  // last returned time + step.
+  size_t read(uint32_t from, uint32_t to, uint32_t step, HistorySample* out, size_t maxSamples) const {
+    size_t n = 0;
+    uint32_t nextTime = from;
+    step = max(step, (uint32_t)1);
+
+    for (size_t k = 0; k < filled && n < maxSamples; k++) {
+      size_t b = blockAt(k);
+      const BlockHeader& h = header(b);
+      if (h.endTime < nextTime) {
+        continue;
+      }
+      if (h.startTime > to) {
+        break;
+      }
+
+      const uint8_t* data = block(b);
+      size_t pos = sizeof(BlockHeader);
+      uint32_t time = h.startTime;
+      int32_t values[HISTORY_CHANNELS] = {0};
+      for (uint16_t i = 0; i < h.count; i++) {
+        time += readVarint(data, pos);
+        for (int c = 0; c < HISTORY_CHANNELS; c++) {
+          values[c] = (int32_t)((uint32_t)values[c] + (uint32_t)unzigzag(readVarint(data, pos)));
+        }
+        if (time > to) {
+          return n;
+        }
+        if (time >= nextTime) {
+          dequantize(time, values, out[n++]);
+          nextTime = time + step;
+          if (n == maxSamples) {
+            return n;
+          }
+        }
+      }
+    }
+    return n;
+  }
+
+private:
+  struct BlockHeader {
+    uint32_t startTime;
+    uint32_t endTime;
+    uint16_t count;
+    uint16_t used;  // Bytes including this header
+  };
+
+  // Time gap plus one delta per channel, each at most a 5-byte varint
+  static const size_t MAX_RECORD_SIZE = 5 * (HISTORY_CHANNELS + 1);
+
+  // Quantization step per channel: 0.01 °C, 0.01 %RH, 0.001 kPa, 0.01 pH,
+  // 0.01 L and raw ADC counts
+  static float scale(int channel) {
+    static const float scales[HISTORY_CHANNELS] = {100.0, 100.0, 1000.0, 100.0, 100.0, 1.0};
+    return scales[channel];
+  }
+
+  static void quantize(const HistorySample& sample, int32_t* values) {
+    const float raw[HISTORY_CHANNELS] = {sample.temperature, sample.humidity, sample.vpd,
+                                         sample.pH, sample.reservoirVolume, sample.lightIntensity};
+    for (int c = 0; c < HISTORY_CHANNELS; c++) {
+      values[c] = isnan(raw[c]) ? HISTORY_MISSING : (int32_t)lroundf(raw[c] * scale(c));
+    }
+  }
+
+  static void dequantize(uint32_t time, const int32_t* values, HistorySample& sample) {
+    float raw[HISTORY_CHANNELS];
+    for (int c = 0; c < HISTORY_CHANNELS; c++) {
+      raw[c] = values[c] == HISTORY_MISSING ? NAN : values[c] / scale(c);
+    }
+    sample.time = time;
+    sample.temperature = raw[0];
+    sample.humidity = raw[1];
+    sample.vpd = raw[2];
+    sample.pH = raw[3];
+    sample.reservoirVolume = raw[4];
+    sample.lightIntensity = raw[5];
+  }
+
+  // Deltas are taken with wrapping arithmetic so jumps to and from
+  // HISTORY_MISSING round-trip exactly
+  static size_t encode(uint8_t* out, uint32_t gap, const int32_t* values, const int32_t* previous) {
+    size_t length = writeVarint(out, gap);
+    for (int c = 0; c < HISTORY_CHANNELS; c++) {
+      int32_t delta = (int32_t)((uint32_t)values[c] - (uint32_t)previous[c]);
+      length += writeVarint(out + length, zigzag(delta));
+    }
+    return length;
+  }
+
+  static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+  }
+
+  static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+  }
+
+  static size_t writeVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+      out[n++] = (uint8_t)(v | 0x80);
+      v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+  }
+
+  static uint32_t readVarint(const uint8_t* data, size_t& pos) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      uint8_t byte = data[pos++];
+      v |= (uint32_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        break;
+      }
+    }
+    return v;
+  }
+
+  void startBlock(uint32_t time) {
+    if (!empty()) {
+      head = (head + 1) % blockCount;
+    }
+    if (filled < blockCount) {
+      filled++;
+    }
+    BlockHeader& h = header(head);
+    h.startTime = time;
+    h.endTime = time;
+    h.count = 0;
+    h.used = sizeof(BlockHeader);
+  }
+
+  // k-th block in age order, 0 being the oldest
+  size_t blockAt(size_t k) const {
+    return (head + blockCount - filled + 1 + k) % blockCount;
+  }
+
+  uint8_t* block(size_t b) const {
+    return arena + b * HISTORY_BLOCK_SIZE;
+  }
+
+  BlockHeader& header(size_t b) const {
+    return *reinterpret_cast<BlockHeader*>(block(b));
+  }
+
+  uint8_t* arena = NULL;
+  size_t blockCount = 0;
+  size_t head = 0;    // Block being appended to
+  size_t filled = 0;  // Blocks holding data
+  int32_t lastValues[HISTORY_CHANNELS] = {0};
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef HOST_ACCELSTEPPER_H
+#define HOST_ACCELSTEPPER_H
+
+#include "Arduino.h"
+
+// Timing model of AccelStepper for the simulator. run() takes at most one
+// step, and only once the step interval has passed on the virtual clock, so
+// a caller that does not run() often enough slows the move down just like on
+// hardware. Steps happen at the max speed; acceleration is not modelled.
+class AccelStepper {
+public:
+  enum MotorInterfaceType { FUNCTION = 0, DRIVER = 1, FULL2WIRE = 2, FULL4WIRE = 4 };
+
+  AccelStepper(uint8_t interface = DRIVER, uint8_t stepPin = 2, uint8_t dirPin = 3) {}
+
+  void setMaxSpeed(float speed) {
+    maxSpeed = speed > 0 ? speed : 1;
+  }
+
+  void setAcceleration(float acceleration) {}
+
+  void moveTo(long absolute) {
+    target = absolute;
+  }
+
+  long currentPosition() const {
+    return position;
+  }
+
+  long distanceToGo() const {
+    return target - position;
+  }
+
+  bool run() {
+    if (position == target) {
+      return false;
+    }
+    uint32_t now = micros();
+    uint32_t interval = (uint32_t)(1000000.0 / maxSpeed);
+    if (now - lastStepTime < interval) {
+      return true;
+    }
+    lastStepTime = now;
+    position += target > position ? 1 : -1;
+    stepCount++;
+    return position != target;
+  }
+
+  unsigned long stepCount = 0;  // Steps taken since construction
+
+private:
+  float maxSpeed = 1;
+  long position = 0;
+  long target = 0;
+  uint32_t lastStepTime = 0;
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef HOST_ADAFRUIT_SHT31_H
+#define HOST_ADAFRUIT_SHT31_H
+
+#include "Arduino.h"
+
+// Simulated SHT31 reading the plant model's air. A measurement blocks for
+// 20 ms of virtual time, as the Adafruit driver's delay() does on hardware.
+class Adafruit_SHT31 {
+public:
+  bool begin(uint8_t address = 0x44);
+  float readTemperature();
+  float readHumidity();
+  bool readBoth(float* temperature, float* humidity);
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host (Linux) stand-in for the Arduino core, just wide enough to compile the
+// controller sketches natively. Time comes from the simulator's virtual clock
+// (hal.h) and pins are backed by the plant model, so nothing here touches
+// real hardware.
+//
+// Pin names follow the Uno unless the including file defines
+// HOST_BOARD_ESP8266 first, as sim_esp8266.cpp does.
+//
+// millis() and micros() return uint32_t rather than unsigned long: on Linux
+// unsigned long is 64 bits and would hide the rollover the boards see.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) (p)
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+#if defined(HOST_BOARD_ESP8266)
+// NodeMCU pin labels, mapped to their GPIO numbers
+#define A0 17
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define SDA 4
+#define SCL 5
+#else
+// Uno
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define SDA A4
+#define SCL A5
+#endif
+
+#define F(s) (s)
+#define PSTR(s) (s)
+#define PROGMEM
+#define snprintf_P snprintf
+typedef const char* PGM_P;
+
+#define constrain(x, lo, hi) ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+
+// Templates instead of the usual macros so the C++ standard headers still compile
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type min(A a, B b) {
+  return a < b ? a : b;
+}
+
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type max(A a, B b) {
+  return a > b ? a : b;
+}
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000);
+void attachInterrupt(int interrupt, void (*isr)(), int mode);
+void detachInterrupt(int interrupt);
+void noInterrupts();
+void interrupts();
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t byte) = 0;
+  size_t write(const uint8_t* data, size_t length);
+  size_t write(const char* text, size_t length) {
+    return write((const uint8_t*)text, length);
+  }
+
+  size_t print(const char* text);
+  size_t print(char c);
+  size_t print(int value, int base = 10);
+  size_t print(unsigned int value, int base = 10);
+  size_t print(long value, int base = 10);
+  size_t print(unsigned long value, int base = 10);
+  size_t print(double value, int digits = 2);
+
+  size_t println();
+  template <typename T>
+  size_t println(T value) {
+    size_t n = print(value);
+    return n + println();
+  }
+  template <typename T>
+  size_t println(T value, int format) {
+    size_t n = print(value, format);
+    return n + println();
+  }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+};
+
+// The UART. Output is paced at the configured baud rate against the virtual
+// clock, with a 64-byte transmit buffer like the AVR core, so long debug
+// prints cost the loop the same time they would on the board.
+#define SERIAL_8N1 0x06
+#define SERIAL_FULL 0
+#define SERIAL_RX_ONLY 1
+#define SERIAL_TX_ONLY 2
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud);
+  void begin(unsigned long baud, int config, int mode = SERIAL_FULL) {
+    begin(baud);
+  }
+  size_t write(uint8_t byte) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  operator bool() const {
+    return true;
+  }
+};
+
+extern HardwareSerial Serial;
+
+#endif
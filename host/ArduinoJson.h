@@ -0,0 +1,312 @@
+#ifndef HOST_ARDUINOJSON_H
+#define HOST_ARDUINOJSON_H
+
+#include "Arduino.h"
+
+// Stand-in for the part of ArduinoJson 6 the /control parser uses, for hosts
+// without the library: a document whose one heap block of `capacity` bytes
+// holds the parsed object, as DynamicJsonDocument's pool does, and a
+// deserializeJson() for flat objects of strings, numbers, booleans and null.
+// Nested values are skipped. Parse timings taken with it are the stand-in's,
+// not the library's; the heap use matches.
+
+class DeserializationError {
+public:
+  enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory };
+
+  DeserializationError(Code code) : code_(code) {}
+
+  explicit operator bool() const {
+    return code_ != Ok;
+  }
+
+  Code code() const {
+    return code_;
+  }
+
+private:
+  Code code_;
+};
+
+class JsonVariantConst {
+public:
+  enum Type : uint8_t { NUL, STRING, NUMBER, BOOLEAN };
+
+  JsonVariantConst() : type(NUL), string(NULL), number(0) {}
+  JsonVariantConst(Type type, const char* string, double number) : type(type), string(string), number(number) {}
+
+  template <typename T>
+  bool is() const;
+
+  template <typename T>
+  T as() const;
+
+  const char* operator|(const char* fallback) const {
+    return type == STRING ? string : fallback;
+  }
+
+private:
+  Type type;
+  const char* string;
+  double number;
+};
+
+template <>
+inline bool JsonVariantConst::is<const char*>() const {
+  return type == STRING;
+}
+
+template <>
+inline const char* JsonVariantConst::as<const char*>() const {
+  return type == STRING ? string : NULL;
+}
+
+// Like ArduinoJson, a string is not converted to a number
+template <>
+inline float JsonVariantConst::as<float>() const {
+  return type == NUMBER || type == BOOLEAN ? (float)number : 0;
+}
+
+template <>
+inline int JsonVariantConst::as<int>() const {
+  return type == NUMBER || type == BOOLEAN ? (int)number : 0;
+}
+
+class DynamicJsonDocument {
+public:
+  explicit DynamicJsonDocument(size_t capacity)
+      : pool(new uint8_t[capacity]), capacity(capacity), used(0), members(NULL), count(0) {}
+
+  ~DynamicJsonDocument() {
+    delete[] pool;
+  }
+
+  DynamicJsonDocument(const DynamicJsonDocument&) = delete;
+  DynamicJsonDocument& operator=(const DynamicJsonDocument&) = delete;
+
+  bool containsKey(const char* key) const {
+    return find(key) != NULL;
+  }
+
+  JsonVariantConst operator[](const char* key) const {
+    const Member* member = find(key);
+    return member != NULL ? member->value : JsonVariantConst();
+  }
+
+private:
+  struct Member {
+    const char* key;
+    JsonVariantConst value;
+    Member* next;
+  };
+
+  const Member* find(const char* key) const {
+    for (const Member* member = members; member != NULL; member = member->next) {
+      if (strcmp(member->key, key) == 0) {
+        return member;
+      }
+    }
+    return NULL;
+  }
+
+  void clear() {
+    used = 0;
+    members = NULL;
+    count = 0;
+  }
+
+  void* allocate(size_t size, size_t align) {
+    size_t start = (used + align - 1) & ~(align - 1);
+    if (start + size > capacity) {
+      return NULL;
+    }
+    used = start + size;
+    return pool + start;
+  }
+
+  uint8_t* pool;
+  size_t capacity;
+  size_t used;
+  Member* members;
+  size_t count;
+
+  friend class HostJsonParser;
+};
+
+class HostJsonParser {
+public:
+  HostJsonParser(DynamicJsonDocument& doc, const char* input) : doc(doc), p(input) {}
+
+  DeserializationError parse() {
+    doc.clear();
+    skipSpace();
+    if (*p == '\0') {
+      return DeserializationError::EmptyInput;
+    }
+    if (*p++ != '{') {
+      return DeserializationError::InvalidInput;
+    }
+    DynamicJsonDocument::Member** tail = &doc.members;
+    skipSpace();
+    if (*p == '}') {
+      return DeserializationError::Ok;
+    }
+    while (true) {
+      skipSpace();
+      const char* key;
+      DeserializationError error = parseString(key);
+      if (error) {
+        return error;
+      }
+      skipSpace();
+      if (*p++ != ':') {
+        return p[-1] == '\0' ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+      }
+      skipSpace();
+      JsonVariantConst value;
+      error = parseValue(value);
+      if (error) {
+        return error;
+      }
+      auto* member = (DynamicJsonDocument::Member*)doc.allocate(sizeof(DynamicJsonDocument::Member),
+                                                              alignof(DynamicJsonDocument::Member));
+      if (member == NULL) {
+        return DeserializationError::NoMemory;
+      }
+      *member = {key, value, NULL};
+      *tail = member;
+      tail = &member->next;
+      doc.count++;
+
+      skipSpace();
+      char c = *p++;
+      if (c == '}') {
+        return DeserializationError::Ok;
+      }
+      if (c != ',') {
+        return c == '\0' ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+      }
+    }
+  }
+
+private:
+  void skipSpace() {
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+      p++;
+    }
+  }
+
+  // Copied into the pool, as ArduinoJson does for read-only input
+  DeserializationError parseString(const char*& out) {
+    if (*p != '"') {
+      return *p == '\0' ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+    }
+    p++;
+    const char* end = p;
+    while (*end != '"') {
+      if (*end == '\0' || (*end == '\\' && end[1] == '\0')) {
+        return DeserializationError::IncompleteInput;
+      }
+      end += *end == '\\' ? 2 : 1;
+    }
+    char* copy = (char*)doc.allocate(end - p + 1, 1);
+    if (copy == NULL) {
+      return DeserializationError::NoMemory;
+    }
+    char* w = copy;
+    while (p < end) {
+      char c = *p++;
+      if (c == '\\') {
+        c = *p++;
+        switch (c) {
+          case 'n': c = '\n'; break;
+          case 't': c = '\t'; break;
+          case 'r': c = '\r'; break;
+          case 'b': c = '\b'; break;
+          case 'f': c = '\f'; break;
+          case 'u': c = '?'; p = min(p + 4, end); break;  // Not needed for /control
+        }
+      }
+      *w++ = c;
+    }
+    *w = '\0';
+    p = end + 1;
+    out = copy;
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError parseValue(JsonVariantConst& out) {
+    if (*p == '"') {
+      const char* string = NULL;
+      DeserializationError error = parseString(string);
+      out = JsonVariantConst(JsonVariantConst::STRING, string, 0);
+      return error;
+    }
+    if (*p == '{' || *p == '[') {
+      return skipNested();
+    }
+    if (literal("true")) {
+      out = JsonVariantConst(JsonVariantConst::BOOLEAN, NULL, 1);
+      return DeserializationError::Ok;
+    }
+    if (literal("false")) {
+      out = JsonVariantConst(JsonVariantConst::BOOLEAN, NULL, 0);
+      return DeserializationError::Ok;
+    }
+    if (literal("null")) {
+      out = JsonVariantConst();
+      return DeserializationError::Ok;
+    }
+    char* end;
+    double number = strtod(p, &end);
+    if (end == p) {
+      return *p == '\0' ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+    }
+    p = end;
+    out = JsonVariantConst(JsonVariantConst::NUMBER, NULL, number);
+    return DeserializationError::Ok;
+  }
+
+  bool literal(const char* word) {
+    size_t length = strlen(word);
+    if (strncmp(p, word, length) != 0) {
+      return false;
+    }
+    p += length;
+    return true;
+  }
+
+  DeserializationError skipNested() {
+    int depth = 0;
+    bool inString = false;
+    do {
+      char c = *p++;
+      if (c == '\0') {
+        return DeserializationError::IncompleteInput;
+      }
+      if (inString) {
+        if (c == '\\' && *p != '\0') {
+          p++;
+        } else if (c == '"') {
+          inString = false;
+        }
+      } else if (c == '"') {
+        inString = true;
+      } else if (c == '{' || c == '[') {
+        depth++;
+      } else if (c == '}' || c == ']') {
+        depth--;
+      }
+    } while (depth > 0);
+    return DeserializationError::Ok;
+  }
+
+  DynamicJsonDocument& doc;
+  const char* p;
+};
+
+inline DeserializationError deserializeJson(DynamicJsonDocument& doc, const char* input) {
+  return HostJsonParser(doc, input).parse();
+}
+
+#endif
@@ -0,0 +1,491 @@
+// Microbenchmarks for the hot numeric and serialization paths, built natively
+// against the host HAL. Timings are for the host CPU, so compare runs against
+// each other (bench_baseline.json), not against the boards. Every benchmark
+// also reports heap allocations and bytes per iteration, which should stay
+// at zero on these paths.
+#include "../ard.cpp"
+#include "../control_command.h"
+#include "../data_json.h"
+#include "../esp32_zones.h"
+#include "../esp32/sensor_monitor/uplink_batch.h"
+#include "../history.h"
+#include "hal.h"
+#include "plant.h"
+#include "sim.h"
+
+#include <benchmark/benchmark.h>
+#include <new>
+
+// GCC sees the malloc() behind operator new and flags the matching free()
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+static uint64_t allocations = 0;
+static uint64_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+  allocations++;
+  allocatedBytes += size;
+  void* p = malloc(size);
+  if (p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+// Counts heap use between construction and report()
+class AllocationCounter {
+public:
+  AllocationCounter() : startCount(allocations), startBytes(allocatedBytes) {}
+
+  void report(benchmark::State& state) {
+    state.counters["allocs/op"] =
+        benchmark::Counter(allocations - startCount, benchmark::Counter::kAvgIterations);
+    state.counters["bytes/op"] =
+        benchmark::Counter(allocatedBytes - startBytes, benchmark::Counter::kAvgIterations);
+  }
+
+private:
+  uint64_t startCount;
+  uint64_t startBytes;
+};
+
+// A noisy pH probe around 6.0 for the sampler's readPH()
+static int probeRead(uint8_t pin) {
+  static uint32_t n = 0;
+  n = n * 1103515245 + 12345;
+  return 438 + (int)((n >> 16) % 7) - 3;
+}
+
+// The formula calculateVPD() approximates, in double as the sketches had it
+static double referenceVPD(double temperature, double humidity) {
+  double svp = 0.6108 * exp(17.27 * temperature / (temperature + 237.3));
+  return svp - humidity / 100.0 * svp;
+}
+
+// Worst error of calculateVPD() over 0-50 °C and 0-100 %RH, in kPa. The bound
+// is the one documented on saturationVaporPressure().
+#define VPD_MAX_ERROR 4e-5
+
+static bool checkVPDAccuracy() {
+  double worst = 0;
+  float worstTemperature = 0;
+  for (int i = 0; i <= 50000; i++) {
+    float temperature = i * 0.001f;
+    for (int humidity = 0; humidity <= 100; humidity += 10) {
+      double error = fabs(calculateVPD(temperature, humidity) - referenceVPD(temperature, humidity));
+      if (error > worst) {
+        worst = error;
+        worstTemperature = temperature;
+      }
+    }
+  }
+  bool ok = worst <= VPD_MAX_ERROR && isnan(calculateVPD(NAN, 50));
+  printf("calculateVPD max error %.2e kPa at %.3f C (bound %.0e): %s\n", worst, worstTemperature,
+         VPD_MAX_ERROR, ok ? "ok" : "FAILED");
+  return ok;
+}
+
+static void BM_CalculateVPDReference(benchmark::State& state) {
+  double temperature = 24.0;
+  double humidity = 55.0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(temperature);
+    benchmark::DoNotOptimize(humidity);
+    benchmark::DoNotOptimize(referenceVPD(temperature, humidity));
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_CalculateVPDReference);
+
+static void BM_CalculateVPD(benchmark::State& state) {
+  float temperature = 24.0;
+  float humidity = 55.0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(temperature);
+    benchmark::DoNotOptimize(humidity);
+    benchmark::DoNotOptimize(calculateVPD(temperature, humidity));
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_CalculateVPD);
+
+static void BM_CalculateReservoirVolume(benchmark::State& state) {
+  float level = 27.5;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(level);
+    benchmark::DoNotOptimize(control.reservoirVolume(level));
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_CalculateReservoirVolume);
+
+// The Uno and ESP8266 path: PH_OVERSAMPLE analogRead()s, the filter's sort
+// and the scaling
+static void BM_ReadPH(benchmark::State& state) {
+  hal::Hooks hooks;
+  hooks.analogRead = probeRead;
+  hal::setHooks(hooks);
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sampler.readPH());
+  }
+  counter.report(state);
+  hal::setHooks(hal::Hooks());
+}
+BENCHMARK(BM_ReadPH);
+
+// The ESP32 path with zone 1's profile: the continuous ADC's frames for one
+// pH sample go through pushAdc(), then readPH() takes the filtered value.
+// At 500 Hz per pin and 32 conversions per frame that is ~16 frames a second.
+#define PH_FRAMES_PER_SAMPLE 16
+
+static void BM_ReadPHContinuous(benchmark::State& state) {
+  SensorSnapshot snapshot;
+  SensorSampler<Zone1Board> esp32Sampler(snapshot);
+  uint16_t raw[PH_FRAMES_PER_SAMPLE];
+  for (int i = 0; i < PH_FRAMES_PER_SAMPLE; i++) {
+    raw[i] = 1755 + probeRead(0) - 438;  // ~pH 6.0 at 12 bits
+  }
+  AllocationCounter counter;
+  for (auto _ : state) {
+    for (int i = 0; i < PH_FRAMES_PER_SAMPLE; i++) {
+      esp32Sampler.pushAdc(Zone1Board::phPin, raw[i]);
+    }
+    benchmark::DoNotOptimize(esp32Sampler.readPH());
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_ReadPHContinuous);
+
+static void BM_AdcFilterValue(benchmark::State& state) {
+  AdcFilter<16> filter;
+  for (int i = 0; i < 16; i++) {
+    filter.push(probeRead(0));
+  }
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter.value());
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_AdcFilterValue);
+
+// What the ESP32's publishData() does per update: format every zone's
+// fields, then render the /data body. Keys and buffer size are built as
+// setup() builds them, for the two zones esp32.cpp runs and for four.
+static void BM_WriteDataJson(benchmark::State& state) {
+  const uint8_t zoneCount = state.range(0);
+  const char* const zoneNames[] = {"1", "2", "3", "4"};
+  char keys[4 * ZONE_FIELD_COUNT][DATA_KEY_SIZE];
+  DataField fields[4 * ZONE_FIELD_COUNT];
+  const int count = zoneCount * ZONE_FIELD_COUNT;
+  for (int i = 0; i < count; i++) {
+    zoneDataKey(keys[i], i < ZONE_FIELD_COUNT, zoneNames[i / ZONE_FIELD_COUNT], i % ZONE_FIELD_COUNT);
+    fields[i].key = keys[i];
+  }
+
+  SensorSnapshot snapshot;
+  snapshot.climateValid = true;
+  snapshot.temperature = 24.31;
+  snapshot.humidity = 55.72;
+  snapshot.vpd = 1.342;
+  snapshot.pH = 6.08;
+  snapshot.waterLevel = 27.5;
+  snapshot.reservoirVolume = 37.7;
+  snapshot.lightIntensity = 2612;
+  ControlState control;
+  control.isVPDPumping = true;
+  control.phStatus = "adjusting";
+
+  char json[4 * ZONE_DATA_JSON_SIZE];
+  const size_t size = zoneCount * ZONE_DATA_JSON_SIZE;
+  uint32_t version = 0;
+  size_t length = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    for (uint8_t zone = 0; zone < zoneCount; zone++) {
+      formatZoneFields(fields + zone * ZONE_FIELD_COUNT, snapshot, control);
+    }
+    length = writeDataJson(json, size, ++version, 123456, fields, count);
+    benchmark::DoNotOptimize(json);
+    benchmark::DoNotOptimize(length);
+  }
+  counter.report(state);
+  state.SetBytesProcessed(state.iterations() * length);
+  state.counters["body bytes"] = length;
+  state.counters["buffer bytes"] = size;
+}
+BENCHMARK(BM_WriteDataJson)->Arg(2)->Arg(4);
+
+// Four zones for BM_ZoneLoopPass. The S3 has no GPIOs left for zones 3 and
+// 4 (see WIRING.md), so their relays, ranger and stepper sit on host pins
+// 44-63 standing in for an I/O expander, and their probes on pins the
+// continuous ADC could not reach. With four SHT31s, zone 1's goes behind the
+// mux with zones 3 and 4's; zone 2's stays at 0x45 outside it.
+struct LoopZone1Board : Zone1Board {
+  static constexpr uint8_t i2cMuxChannel = 0;
+};
+struct LoopZone2Board : Zone2Board {};
+struct LoopZone3Board : Zone1Board {
+  static constexpr uint8_t phPin = 44;
+  static constexpr uint8_t ldrPin = 45;
+  static constexpr uint8_t vpdRelay = 46;
+  static constexpr uint8_t acidRelay = 47;
+  static constexpr uint8_t baseRelay = 48;
+  static constexpr uint8_t mixRelay = 49;
+  static constexpr uint8_t trigPin = 50;
+  static constexpr uint8_t echoPin = 51;
+  static constexpr uint8_t stepPin = 52;
+  static constexpr uint8_t dirPin = 53;
+  static constexpr uint8_t i2cMuxChannel = 1;
+};
+struct LoopZone4Board : LoopZone3Board {
+  static constexpr uint8_t phPin = 54;
+  static constexpr uint8_t ldrPin = 55;
+  static constexpr uint8_t vpdRelay = 56;
+  static constexpr uint8_t acidRelay = 57;
+  static constexpr uint8_t baseRelay = 58;
+  static constexpr uint8_t mixRelay = 59;
+  static constexpr uint8_t trigPin = 60;
+  static constexpr uint8_t echoPin = 61;
+  static constexpr uint8_t stepPin = 62;
+  static constexpr uint8_t dirPin = 63;
+  static constexpr uint8_t i2cMuxChannel = 2;
+};
+static_assert(zonesApart<LoopZone1Board, LoopZone2Board>() && zonesApart<LoopZone1Board, LoopZone3Board>() &&
+                  zonesApart<LoopZone1Board, LoopZone4Board>() && zonesApart<LoopZone2Board, LoopZone3Board>() &&
+                  zonesApart<LoopZone2Board, LoopZone4Board>() && zonesApart<LoopZone3Board, LoopZone4Board>(),
+              "Benchmark zones share a pin or an SHT31 address");
+
+#define LOOP_PASS_INTERVAL_US 5000  // Virtual time between passes
+
+// ~pH 6.0 on every probe, at 12 bits
+static int esp32ProbeRead(uint8_t pin) {
+  return 1755 + probeRead(pin) - 438;
+}
+
+// The zone work in one pass of the ESP32's loop() for 1, 2 and 4 zones:
+// serviceRotations(), sampleSensors() with its one SHT31 read per pass taken
+// in turn, and the control jobs; publishData() is BM_WriteDataJson. The
+// virtual clock steps LOOP_PASS_INTERVAL_US between passes. On the board the
+// SHT31 read, the ranger trigger and Serial logging block; here they only
+// move the virtual clock, so they are reported as "blocked us" (mean and
+// worst per pass) rather than in the time.
+static void BM_ZoneLoopPass(benchmark::State& state) {
+  const uint8_t zoneCount = state.range(0);
+  Plant chamber(PlantConfig{});
+  attachPlant(&chamber);
+  hal::Hooks hooks;
+  hooks.analogRead = esp32ProbeRead;
+  hal::setHooks(hooks);
+  hal::reset(0);
+  Serial.begin(115200);
+
+  BoardZone<LoopZone1Board> zone1("1");
+  BoardZone<LoopZone2Board> zone2("2");
+  BoardZone<LoopZone3Board> zone3("3");
+  BoardZone<LoopZone4Board> zone4("4");
+  Zone* const zones[] = {&zone1, &zone2, &zone3, &zone4};
+  for (uint8_t i = 0; i < zoneCount; i++) {
+    zones[i]->begin();
+  }
+
+  uint8_t climateTurn = 0;
+  uint64_t blockedMicros = 0;
+  uint64_t maxBlockedMicros = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    uint64_t passStart = hal::nowMicros();
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < zoneCount; i++) {
+      zones[i]->serviceRotation();
+    }
+    bool climateAllowed = true;
+    uint8_t first = climateTurn;
+    for (uint8_t i = 0; i < zoneCount; i++) {
+      uint8_t index = (first + i) % zoneCount;
+      bool climateRead;
+      zones[index]->sample(now, climateAllowed, climateRead);
+      if (climateRead) {
+        climateAllowed = false;
+        climateTurn = (index + 1) % zoneCount;
+      }
+    }
+    for (uint8_t i = 0; i < zoneCount; i++) {
+      benchmark::DoNotOptimize(zones[i]->runVPD(now));
+      benchmark::DoNotOptimize(zones[i]->runPH(now));
+      benchmark::DoNotOptimize(zones[i]->runReservoir(now));
+      benchmark::DoNotOptimize(zones[i]->runRotation(now));
+    }
+    uint64_t blocked = hal::nowMicros() - passStart;
+    blockedMicros += blocked;
+    maxBlockedMicros = max(maxBlockedMicros, blocked);
+    hal::advance(LOOP_PASS_INTERVAL_US);
+  }
+  counter.report(state);
+  state.counters["blocked us"] = benchmark::Counter(blockedMicros, benchmark::Counter::kAvgIterations);
+  state.counters["max blocked us"] = maxBlockedMicros;
+  hal::setHooks(hal::Hooks());
+  attachPlant(NULL);
+}
+BENCHMARK(BM_ZoneLoopPass)->Arg(1)->Arg(2)->Arg(4);
+
+// The ESP32's /control handler: parse a dashboard body into a command. On the
+// host ArduinoJson is host/ArduinoJson.h, so the time is the stand-in's; the
+// document's pool is the one allocation per request, as on the board.
+static void BM_ParseControl(benchmark::State& state) {
+  const char* const zoneNames[] = {"1", "2"};
+  const char* body = "{\"zone\":\"2\",\"pHTarget\":\"6.2\"}";
+  ControlCommand command;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(parseControlCommand(body, zoneNames, 2, command));
+    benchmark::DoNotOptimize(command);
+  }
+  counter.report(state);
+  state.SetBytesProcessed(state.iterations() * strlen(body));
+}
+BENCHMARK(BM_ParseControl);
+
+static SensorData sampleTelemetry() {
+  SensorData data = {};
+  data.sequence = 7;
+  data.temperature = 24.3;
+  data.humidity = 55.7;
+  data.vpd = 1.34;
+  data.pH = 6.08;
+  data.waterLevel = 27.5;
+  data.reservoirVolume = 37.7;
+  data.lightIntensity = 612;
+  return data;
+}
+
+static void BM_EncodeTelemetry(benchmark::State& state) {
+  SensorData data = sampleTelemetry();
+  uint8_t frame[BRIDGE_MAX_FRAME];
+  AllocationCounter counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(encodeTelemetry(data, frame));
+    benchmark::ClobberMemory();
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_EncodeTelemetry);
+
+// The ESP8266 side of a telemetry frame: byte-at-a-time assembly, CRC, decode
+static void BM_ReceiveTelemetry(benchmark::State& state) {
+  SensorData data = sampleTelemetry();
+  uint8_t frame[BRIDGE_MAX_FRAME];
+  size_t length = encodeTelemetry(data, frame);
+  FrameAssembler assembler;
+  SensorData decoded;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    for (size_t i = 0; i < length; i++) {
+      if (assembler.push(frame[i])) {
+        benchmark::DoNotOptimize(decodeTelemetry(assembler.payload(), assembler.payloadLength(), decoded));
+      }
+    }
+  }
+  counter.report(state);
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_ReceiveTelemetry);
+
+static HistorySample historySample(uint32_t time) {
+  HistorySample sample;
+  sample.time = time;
+  sample.temperature = 24.0 + (time % 13) * 0.05;
+  sample.humidity = 55.0 + (time % 7) * 0.1;
+  sample.vpd = 1.3 + (time % 5) * 0.01;
+  sample.pH = 6.0 + (time % 11) * 0.01;
+  sample.reservoirVolume = 37.7 - time * 0.0001;
+  sample.lightIntensity = 600 + time % 17;
+  return sample;
+}
+
+static void BM_HistoryAppend(benchmark::State& state) {
+  static uint8_t buffer[32 * 1024];
+  SensorHistory history;
+  history.begin(buffer, sizeof(buffer));
+  uint32_t time = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    history.append(historySample(++time));
+  }
+  counter.report(state);
+}
+BENCHMARK(BM_HistoryAppend);
+
+// Decode a full 32 KB history, as a /history request for everything does
+static void BM_HistoryRead(benchmark::State& state) {
+  static uint8_t buffer[32 * 1024];
+  SensorHistory history;
+  history.begin(buffer, sizeof(buffer));
+  for (uint32_t time = 1; time <= 20000; time++) {
+    history.append(historySample(time));
+  }
+  static HistorySample out[256];
+  size_t samples = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    uint32_t from = history.oldestTime();
+    size_t n;
+    do {
+      n = history.read(from, history.newestTime(), 1, out, 256);
+      samples += n;
+      if (n > 0) {
+        from = out[n - 1].time + 1;
+      }
+    } while (n == 256);
+  }
+  counter.report(state);
+  state.SetItemsProcessed(samples);
+}
+BENCHMARK(BM_HistoryRead);
+
+// sensor_monitor's uplink: a minute of 5 s SHT31 samples into one frame
+static void BM_EncodeUplinkBatch(benchmark::State& state) {
+  uint8_t frame[256];
+  UplinkBatch<2> batch;
+  batch.begin(frame, sizeof(frame));
+  size_t bytes = 0;
+  AllocationCounter counter;
+  for (auto _ : state) {
+    batch.reset();
+    for (uint32_t i = 0; i < 12; i++) {
+      const float values[2] = {24.31f + (i % 3) * 0.02f, 55.72f - (i % 4) * 0.05f};
+      batch.add(5000 * i + (i & 1), values);
+    }
+    bytes += batch.length();
+    benchmark::DoNotOptimize(frame);
+  }
+  counter.report(state);
+  state.SetItemsProcessed(state.iterations() * 12);
+  state.counters["bytes/sample"] = benchmark::Counter(bytes / 12.0, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_EncodeUplinkBatch);
+
+int main(int argc, char** argv) {
+  if (!checkVPDAccuracy()) {
+    return 1;
+  }
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
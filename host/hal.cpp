@@ -0,0 +1,292 @@
+#include "Arduino.h"
+#include "hal.h"
+
+#include <stdarg.h>
+#include <deque>
+#include <queue>
+#include <vector>
+
+// Virtual clock, pins and UART behind host/Arduino.h
+
+#define HAL_PINS 64
+#define SERIAL_TX_BUFFER 64
+
+namespace {
+
+struct Edge {
+  uint64_t at;
+  uint8_t pin;
+  uint8_t level;
+  bool operator>(const Edge& other) const {
+    return at > other.at;
+  }
+};
+
+uint64_t clockMicros = 0;
+hal::Hooks hooks;
+uint8_t pinLevels[HAL_PINS];
+void (*pinIsrs[HAL_PINS])() = {nullptr};
+std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> edges;
+
+std::deque<uint8_t> serialRx;
+uint64_t serialByteMicros = 1042;  // 9600 baud until begin() says otherwise
+uint64_t serialTxFreeAt = 0;       // When the last queued byte will have left the UART
+uint64_t serialWritten = 0;
+bool serialEcho = false;
+
+void fireEdge(const Edge& edge) {
+  bool changed = pinLevels[edge.pin] != edge.level;
+  pinLevels[edge.pin] = edge.level;
+  if (changed && pinIsrs[edge.pin] != nullptr) {
+    pinIsrs[edge.pin]();
+  }
+}
+
+}  // namespace
+
+namespace hal {
+
+void setHooks(const Hooks& newHooks) {
+  hooks = newHooks;
+}
+
+void reset(uint64_t startMs) {
+  clockMicros = startMs * 1000;
+  memset(pinLevels, 0, sizeof(pinLevels));
+  memset(pinIsrs, 0, sizeof(pinIsrs));
+  edges = decltype(edges)();
+  serialRx.clear();
+  serialTxFreeAt = clockMicros;
+  serialWritten = 0;
+}
+
+uint64_t nowMicros() {
+  return clockMicros;
+}
+
+void advance(uint64_t micros) {
+  uint64_t target = clockMicros + micros;
+  while (!edges.empty() && edges.top().at <= target) {
+    Edge edge = edges.top();
+    edges.pop();
+    if (edge.at > clockMicros) {
+      clockMicros = edge.at;
+      if (hooks.tick) {
+        hooks.tick(clockMicros);
+      }
+    }
+    fireEdge(edge);
+  }
+  clockMicros = target;
+  if (hooks.tick) {
+    hooks.tick(clockMicros);
+  }
+}
+
+void scheduleEdge(uint64_t atMicros, uint8_t pin, uint8_t level) {
+  if (pin < HAL_PINS) {
+    edges.push({atMicros, pin, level});
+  }
+}
+
+void injectSerial(const uint8_t* data, size_t length) {
+  serialRx.insert(serialRx.end(), data, data + length);
+}
+
+void setSerialEcho(bool echo) {
+  serialEcho = echo;
+}
+
+uint64_t serialBytesWritten() {
+  return serialWritten;
+}
+
+}  // namespace hal
+
+uint32_t millis() {
+  return (uint32_t)(clockMicros / 1000);
+}
+
+uint32_t micros() {
+  return (uint32_t)clockMicros;
+}
+
+void delay(uint32_t ms) {
+  hal::advance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+  hal::advance(us);
+}
+
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin >= HAL_PINS) {
+    return;
+  }
+  pinLevels[pin] = value ? HIGH : LOW;
+  if (hooks.pinWritten) {
+    hooks.pinWritten(pin, pinLevels[pin]);
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= HAL_PINS) {
+    return LOW;
+  }
+  return hooks.digitalRead ? hooks.digitalRead(pin, pinLevels[pin]) : pinLevels[pin];
+}
+
+int analogRead(uint8_t pin) {
+  return hooks.analogRead ? hooks.analogRead(pin) : 0;
+}
+
+// Busy-waits on the virtual clock like the real pulseIn() does on the CPU
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout) {
+  uint64_t start = clockMicros;
+  while (digitalRead(pin) == state) {
+    if (clockMicros - start >= timeout) return 0;
+    hal::advance(1);
+  }
+  while (digitalRead(pin) != state) {
+    if (clockMicros - start >= timeout) return 0;
+    hal::advance(1);
+  }
+  uint64_t rise = clockMicros;
+  while (digitalRead(pin) == state) {
+    if (clockMicros - start >= timeout) return 0;
+    hal::advance(1);
+  }
+  return clockMicros - rise;
+}
+
+void attachInterrupt(int interrupt, void (*isr)(), int mode) {
+  if (interrupt >= 0 && interrupt < HAL_PINS) {
+    pinIsrs[interrupt] = isr;
+  }
+}
+
+void detachInterrupt(int interrupt) {
+  if (interrupt >= 0 && interrupt < HAL_PINS) {
+    pinIsrs[interrupt] = nullptr;
+  }
+}
+
+void noInterrupts() {}
+void interrupts() {}
+
+size_t Print::write(const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    write(data[i]);
+  }
+  return length;
+}
+
+size_t Print::print(const char* text) {
+  return write(text, strlen(text));
+}
+
+size_t Print::print(char c) {
+  return write((uint8_t)c);
+}
+
+static size_t printNumber(Print& out, unsigned long long value, int base, bool negative) {
+  char buffer[72];
+  char* p = buffer + sizeof(buffer);
+  *--p = '\0';
+  if (base < 2 || base > 16) {
+    base = 10;
+  }
+  do {
+    *--p = "0123456789ABCDEF"[value % base];
+    value /= base;
+  } while (value > 0);
+  if (negative) {
+    *--p = '-';
+  }
+  return out.print(p);
+}
+
+size_t Print::print(int value, int base) {
+  return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+  return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base) {
+  if (value < 0 && base == 10) {
+    return printNumber(*this, -(unsigned long long)value, 10, true);
+  }
+  return printNumber(*this, (unsigned long)value, base, false);
+}
+
+size_t Print::print(unsigned long value, int base) {
+  return printNumber(*this, value, base, false);
+}
+
+size_t Print::print(double value, int digits) {
+  if (isnan(value)) {
+    return print("nan");
+  }
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return print(buffer);
+}
+
+size_t Print::println() {
+  return print("\r\n");
+}
+
+size_t Print::printf(const char* format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0) {
+    return 0;
+  }
+  return write(buffer, min((size_t)length, sizeof(buffer) - 1));
+}
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud) {
+  serialByteMicros = 10000000ULL / baud;  // Start + 8 data + stop bits
+  serialTxFreeAt = clockMicros;
+}
+
+size_t HardwareSerial::write(uint8_t byte) {
+  if (serialTxFreeAt < clockMicros) {
+    serialTxFreeAt = clockMicros;
+  }
+  serialTxFreeAt += serialByteMicros;
+  // Once the transmit buffer is full, write() blocks until a byte has gone out
+  uint64_t buffered = SERIAL_TX_BUFFER * serialByteMicros;
+  if (serialTxFreeAt - clockMicros > buffered) {
+    hal::advance(serialTxFreeAt - buffered - clockMicros);
+  }
+  serialWritten++;
+  if (serialEcho) {
+    putchar(byte);
+  }
+  return 1;
+}
+
+int HardwareSerial::available() {
+  return (int)serialRx.size();
+}
+
+int HardwareSerial::read() {
+  if (serialRx.empty()) {
+    return -1;
+  }
+  uint8_t byte = serialRx.front();
+  serialRx.pop_front();
+  return byte;
+}
@@ -0,0 +1,46 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Simulator side of the host HAL: the virtual clock and the hooks through
+// which the plant model answers pin reads and sees pin writes. The firmware
+// never includes this; it only sees Arduino.h.
+
+namespace hal {
+
+// Called as the clock moves so the simulator can advance its model.
+// `nowMicros` is the 64-bit virtual time, which never wraps.
+struct Hooks {
+  int (*analogRead)(uint8_t pin) = nullptr;
+  int (*digitalRead)(uint8_t pin, int level) = nullptr;  // `level` is the last written/driven level
+  void (*pinWritten)(uint8_t pin, uint8_t value) = nullptr;
+  void (*tick)(uint64_t nowMicros) = nullptr;
+};
+
+void setHooks(const Hooks& hooks);
+
+// Start the clock at `startMs` so millis() can be made to wrap early in a run
+void reset(uint64_t startMs);
+
+uint64_t nowMicros();
+
+// Move the virtual clock forward, firing any pin edges that fall due
+void advance(uint64_t micros);
+
+// Drive an input pin to `level` at virtual time `atMicros`, calling its
+// interrupt handler if one is attached (the echo of an HC-SR04 ping, say)
+void scheduleEdge(uint64_t atMicros, uint8_t pin, uint8_t level);
+
+// Bytes for the firmware to read from Serial
+void injectSerial(const uint8_t* data, size_t length);
+
+// Copy Serial output to stdout (off by default)
+void setSerialEcho(bool echo);
+
+uint64_t serialBytesWritten();
+
+}  // namespace hal
+
+#endif
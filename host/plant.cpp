@@ -0,0 +1,91 @@
+#include "plant.h"
+
+#include <math.h>
+
+Plant::Plant(const PlantConfig& config)
+    : config(config),
+      rng(config.seed),
+      bulkPH(config.initialPH),
+      level(config.initialLevelCm),
+      airTemperature(config.nightTemperature),
+      airHumidity(config.nightHumidity) {}
+
+double Plant::volumeLiters() const {
+  return M_PI * config.reservoirRadiusCm * config.reservoirRadiusCm * level / 1000.0;
+}
+
+void Plant::step(double dt, double timeOfDay, const Actuators& actuators) {
+  // Daylight: half a sine between 06:00 and 20:00
+  double hours = timeOfDay / 3600.0;
+  daylight = (hours > 6 && hours < 20) ? sin(M_PI * (hours - 6) / 14) : 0;
+
+  // Air follows the sun, warmest and driest mid-afternoon
+  double cycle = 0.5 + 0.5 * sin(2 * M_PI * (hours - 9) / 24);
+  airTemperature = config.nightTemperature + (config.dayTemperature - config.nightTemperature) * cycle;
+  if (actuators.mist) {
+    humidityBoost += config.mistHumidityPerSecond * dt;
+    mistSeconds += dt;
+  }
+  humidityBoost -= humidityBoost * dt / config.humidityDecaySeconds;
+  double ambient = config.nightHumidity + (config.dayHumidity - config.nightHumidity) * cycle;
+  airHumidity = fmin(99.0, ambient + humidityBoost);
+
+  // Water lost to the plants and to misting
+  double liters = volumeLiters();
+  double lost = config.uptakeLitersPerDay * daylight * 2 * dt / 86400.0;
+  if (actuators.mist) {
+    lost += config.mistMlPerSecond * dt / 1000.0;
+  }
+  liters = fmax(0.0, liters - lost);
+  if (config.topUpBelowCm > 0 && level < config.topUpBelowCm) {
+    double full = M_PI * config.reservoirRadiusCm * config.reservoirRadiusCm * config.initialLevelCm / 1000.0;
+    toppedUpLiters += full - liters;
+    liters = full;
+  }
+  level = liters * 1000.0 / (M_PI * config.reservoirRadiusCm * config.reservoirRadiusCm);
+
+  // Dosing goes into the unmixed pool; the bulk catches up over tau
+  if (liters > 0.1) {
+    double ml = config.doseMlPerSecond * dt;
+    if (actuators.acid) {
+      unmixedPH -= ml * config.pHPerMlPerLiter / liters;
+      acidMl += ml;
+    }
+    if (actuators.base) {
+      unmixedPH += ml * config.pHPerMlPerLiter / liters;
+      baseMl += ml;
+    }
+  }
+  double tau = actuators.mix ? config.mixTauSeconds : config.stillTauSeconds;
+  double mixed = unmixedPH * fmin(1.0, dt / tau);
+  unmixedPH -= mixed;
+  bulkPH += mixed + config.pHDriftPerDay * dt / 86400.0;
+  bulkPH = fmin(14.0, fmax(0.0, bulkPH));
+}
+
+double Plant::noise(double sigma) {
+  return std::normal_distribution<double>(0.0, sigma)(rng);
+}
+
+double Plant::measuredPH() {
+  if (config.stuckProbePH > 0) {
+    return config.stuckProbePH;
+  }
+  return bulkPH + noise(0.02);
+}
+
+double Plant::measuredDistanceCm() {
+  return config.reservoirHeightCm - level + noise(0.3);
+}
+
+double Plant::measuredTemperature() {
+  return airTemperature + noise(0.1);
+}
+
+double Plant::measuredHumidity() {
+  return fmin(100.0, fmax(0.0, airHumidity + noise(0.5)));
+}
+
+double Plant::measuredLight() {
+  return fmax(0.0, daylight + noise(0.005));
+}
@@ -0,0 +1,92 @@
+#ifndef HOST_PLANT_H
+#define HOST_PLANT_H
+
+#include <stdint.h>
+#include <random>
+
+// Model of the grow chamber and reservoir the controllers run against.
+//
+// Reservoir: a cylinder losing water to plant uptake (by day) and misting.
+// pH drifts up as the plants take up nutrients. Acid/base pumps dose at a
+// fixed flow; a dose first lands in an unmixed pool and reaches the bulk
+// (which the probe sees) with a time constant that the mix pump shortens.
+// Air: temperature and humidity follow a daily cycle, and misting raises
+// the humidity, which then decays back towards ambient.
+// Light: a daylight curve from 06:00 to 20:00.
+//
+// Every constant is in PlantConfig so runs can be tuned from the command line.
+
+struct PlantConfig {
+  double reservoirRadiusCm = 20.0;
+  double reservoirHeightCm = 35.0;
+  double initialLevelCm = 30.0;
+  double topUpBelowCm = 10.0;      // The grower refills to initialLevelCm below this; 0 disables
+  double initialPH = 6.0;
+  double pHDriftPerDay = 0.3;      // Upward drift from nutrient uptake
+  double doseMlPerSecond = 1.0;    // Acid/base pump flow
+  double pHPerMlPerLiter = 2.0;    // Bulk pH change per ml of acid or base per liter
+  double mixTauSeconds = 5.0;      // Mixing time constant with the mix pump on
+  double stillTauSeconds = 180.0;  // ... and without it
+  double uptakeLitersPerDay = 1.5;
+  double mistMlPerSecond = 0.2;    // Net loss while the misting pump runs (most recirculates)
+  double mistHumidityPerSecond = 0.8;
+  double humidityDecaySeconds = 300.0;
+  double dayTemperature = 26.0;
+  double nightTemperature = 18.0;
+  double dayHumidity = 45.0;
+  double nightHumidity = 70.0;
+  double stuckProbePH = 0;         // A stuck probe reads this whatever the pH; 0 for a working one
+  uint32_t seed = 1;
+};
+
+struct Actuators {
+  bool mist = false;
+  bool acid = false;
+  bool base = false;
+  bool mix = false;
+};
+
+class Plant {
+public:
+  explicit Plant(const PlantConfig& config);
+
+  // Advance the model by `dt` seconds; `timeOfDay` is seconds since midnight
+  void step(double dt, double timeOfDay, const Actuators& actuators);
+
+  double volumeLiters() const;
+
+  // True values
+  double pH() const { return bulkPH; }
+  double levelCm() const { return level; }
+  double temperature() const { return airTemperature; }
+  double humidity() const { return airHumidity; }
+  double light() const { return daylight; }  // 0 (night) to 1 (noon)
+
+  // What the sensors report: the true value plus noise
+  double measuredPH();
+  double measuredDistanceCm();
+  double measuredTemperature();
+  double measuredHumidity();
+  double measuredLight();
+
+  // Running totals for the run summary
+  double acidMl = 0;
+  double baseMl = 0;
+  double mistSeconds = 0;
+  double toppedUpLiters = 0;
+
+private:
+  double noise(double sigma);
+
+  PlantConfig config;
+  std::mt19937 rng;
+  double bulkPH;
+  double unmixedPH = 0;  // pH shift dosed but not yet mixed into the bulk
+  double level;
+  double airTemperature;
+  double airHumidity;
+  double humidityBoost = 0;
+  double daylight = 0;
+};
+
+#endif
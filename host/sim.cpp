@@ -0,0 +1,325 @@
+#include "sim.h"
+
+#include "Adafruit_SHT31.h"
+#include "Arduino.h"
+#include "Wire.h"
+#include "hal.h"
+#include "plant.h"
+
+#include <chrono>
+
+// Simulation harness: wires the HAL hooks to the plant model, runs the
+// sketch for the requested span of virtual time and prints a CSV trace and a
+// summary. Options:
+//
+//   --days N          virtual days to run (default 14)
+//   --start-ms N      millis() at boot (default one hour before it wraps)
+//   --start-hour H    time of day at boot (default 8)
+//   --seed N          sensor noise seed (default 1)
+//   --ph X            initial reservoir pH (default 6.0)
+//   --drift X         pH drift per day (default 0.3)
+//   --buffer X        pH change per ml of acid or base per liter (default 2.0)
+//   --stuck-ph X      the probe reads X whatever the pH (default: a working probe)
+//   --ph-mode M       pi or bangbang dosing (default pi)
+//   --csv S           seconds between trace rows, 0 for none (default 3600)
+//   --serial          echo the sketch's Serial output
+//   --max-on S        fail if any pump stays on longer than this (default 120)
+//   --max-reagent ML  fail if more acid and base than this goes in (default: no limit)
+//   --expect-ph-fault fail unless the sketch has stopped dosing on a pH fault
+//                     by the end; without it, a pH fault fails the run
+//
+// A run also fails if the acid and base pumps are ever on at the same time.
+
+void setup();
+void loop();
+
+TwoWire Wire;
+
+#define LOOP_PASS_US 100     // Virtual CPU time charged for each loop() pass
+#define PLANT_STEP_US 100000 // Plant model resolution
+#define ECHO_DELAY_US 450    // HC-SR04 trigger-to-echo latency
+#define PH_TARGET 6.0        // The sketches' default pHTarget
+#define SETTLE_BAND 0.2
+#define VPD_BAND_LOW 0.8     // The sketches' default VPD band
+#define VPD_BAND_HIGH 1.2
+
+namespace {
+
+struct PumpStats {
+  const char* name;
+  bool on = false;
+  uint64_t onSince = 0;
+  uint32_t activations = 0;
+  double longestOnSeconds = 0;
+};
+
+const SimBoard* board;
+Plant* plant;
+uint64_t bootMicros;
+double startHour = 8;
+uint64_t lastPlantStep;
+uint64_t csvInterval = 3600ULL * 1000000;
+uint64_t nextCsv;
+PumpStats pumps[4] = {{"mist"}, {"acid"}, {"base"}, {"mix"}};
+uint8_t lastTrigLevel = LOW;
+uint32_t reagentOverlaps = 0;  // Times acid and base were on together
+
+double pHMin = 14, pHMax = 0;
+double inBandSeconds = 0, totalSeconds = 0;
+double targetErrorSum = 0;
+double settledSeconds = -1;  // First time within SETTLE_BAND of the target
+uint32_t settledDoses = 0;   // Acid and base runs up to then
+double vpdAboveSeconds = 0, vpdBelowSeconds = 0;
+
+double timeOfDay(uint64_t now) {
+  double seconds = startHour * 3600 + (now - bootMicros) / 1e6;
+  return fmod(seconds, 86400.0);
+}
+
+Actuators actuators() {
+  Actuators a;
+  a.mist = pumps[0].on;
+  a.acid = pumps[1].on;
+  a.base = pumps[2].on;
+  a.mix = pumps[3].on;
+  return a;
+}
+
+void printCsvRow(uint64_t now) {
+  printf("%.3f,%.3f,%.2f,%.2f,%.1f,%.2f,%.1f,%.1f,%.0f\n",
+         (now - bootMicros) / 3.6e9, plant->pH(), plant->levelCm(), plant->temperature(),
+         plant->humidity(), plant->light(), plant->acidMl, plant->baseMl, plant->mistSeconds);
+}
+
+void onTick(uint64_t now) {
+  while (now - lastPlantStep >= PLANT_STEP_US) {
+    lastPlantStep += PLANT_STEP_US;
+    double dt = PLANT_STEP_US / 1e6;
+    plant->step(dt, timeOfDay(lastPlantStep), actuators());
+
+    pHMin = fmin(pHMin, plant->pH());
+    pHMax = fmax(pHMax, plant->pH());
+    totalSeconds += dt;
+    if (plant->pH() >= 5.5 && plant->pH() <= 6.5) {
+      inBandSeconds += dt;
+    }
+    double svp = 0.6108 * exp(17.27 * plant->temperature() / (plant->temperature() + 237.3));
+    double vpd = svp * (1 - plant->humidity() / 100);
+    if (vpd > VPD_BAND_HIGH) {
+      vpdAboveSeconds += dt;
+    } else if (vpd < VPD_BAND_LOW) {
+      vpdBelowSeconds += dt;
+    }
+    targetErrorSum += fabs(plant->pH() - PH_TARGET) * dt;
+    if (settledSeconds < 0 && fabs(plant->pH() - PH_TARGET) <= SETTLE_BAND) {
+      settledSeconds = totalSeconds;
+      settledDoses = pumps[1].activations + pumps[2].activations;
+    }
+    if (board->tick != nullptr) {
+      board->tick(lastPlantStep - bootMicros);
+    }
+    if (csvInterval > 0 && lastPlantStep >= nextCsv) {
+      printCsvRow(lastPlantStep);
+      nextCsv += csvInterval;
+    }
+  }
+}
+
+void onPinWritten(uint8_t pin, uint8_t value) {
+  const uint8_t relays[4] = {board->vpdRelay, board->acidRelay, board->baseRelay, board->mixRelay};
+  uint64_t now = hal::nowMicros();
+  for (int i = 0; i < 4; i++) {
+    if (pin != relays[i]) {
+      continue;
+    }
+    bool on = value == LOW;  // Relay boards are active low
+    PumpStats& pump = pumps[i];
+    if (on && !pump.on) {
+      pump.onSince = now;
+      pump.activations++;
+    } else if (!on && pump.on) {
+      pump.longestOnSeconds = fmax(pump.longestOnSeconds, (now - pump.onSince) / 1e6);
+    }
+    pump.on = on;
+    if (on && pumps[1].on && pumps[2].on) {
+      reagentOverlaps++;
+    }
+  }
+
+  // End of the trigger pulse: answer with an echo as long as the round trip
+  if (pin == board->trigPin) {
+    if (lastTrigLevel == HIGH && value == LOW) {
+      double pulse = plant->measuredDistanceCm() * 2 / 0.034;
+      hal::scheduleEdge(now + ECHO_DELAY_US, board->echoPin, HIGH);
+      hal::scheduleEdge(now + ECHO_DELAY_US + (uint64_t)pulse, board->echoPin, LOW);
+    }
+    lastTrigLevel = value;
+  }
+}
+
+int onAnalogRead(uint8_t pin) {
+  double value = 0;
+  if (pin == board->phPin) {
+    value = plant->measuredPH() / 14.0 * board->adcMax;
+  } else if (pin == board->ldrPin) {
+    value = plant->measuredLight() * 0.9 * board->adcMax;
+  }
+  return (int)constrain(lround(value), 0L, (long)board->adcMax);
+}
+
+int onDigitalRead(uint8_t pin, int level) {
+  if (board->digitalLight && pin == board->ldrPin) {
+    return plant->measuredLight() > 0.3 ? HIGH : LOW;
+  }
+  return level;
+}
+
+}  // namespace
+
+bool Adafruit_SHT31::begin(uint8_t address) {
+  return true;
+}
+
+float Adafruit_SHT31::readTemperature() {
+  delay(20);
+  return plant->measuredTemperature();
+}
+
+float Adafruit_SHT31::readHumidity() {
+  delay(20);
+  return plant->measuredHumidity();
+}
+
+bool Adafruit_SHT31::readBoth(float* temperature, float* humidity) {
+  delay(20);
+  *temperature = plant->measuredTemperature();
+  *humidity = plant->measuredHumidity();
+  return true;
+}
+
+void attachPlant(Plant* model) {
+  plant = model;
+}
+
+int runSimulation(const SimBoard& simBoard, int argc, char** argv) {
+  double days = 14;
+  uint64_t startMs = 0x100000000ULL - 3600000;
+  double maxOnSeconds = 120;
+  double maxReagentMl = INFINITY;
+  bool serial = false;
+  bool expectPHFault = false;
+  PlantConfig config;
+  config.reservoirRadiusCm = simBoard.reservoirRadiusCm;
+  config.reservoirHeightCm = simBoard.reservoirHeightCm;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : "0";
+    if (!strcmp(arg, "--serial")) {
+      serial = true;
+      continue;
+    }
+    if (!strcmp(arg, "--expect-ph-fault")) {
+      expectPHFault = true;
+      continue;
+    }
+    if (!strcmp(arg, "--days")) days = atof(value);
+    else if (!strcmp(arg, "--start-ms")) startMs = strtoull(value, nullptr, 0);
+    else if (!strcmp(arg, "--start-hour")) startHour = atof(value);
+    else if (!strcmp(arg, "--seed")) config.seed = strtoul(value, nullptr, 0);
+    else if (!strcmp(arg, "--ph")) config.initialPH = atof(value);
+    else if (!strcmp(arg, "--drift")) config.pHDriftPerDay = atof(value);
+    else if (!strcmp(arg, "--buffer")) config.pHPerMlPerLiter = atof(value);
+    else if (!strcmp(arg, "--stuck-ph")) config.stuckProbePH = atof(value);
+    else if (!strcmp(arg, "--csv")) csvInterval = (uint64_t)(atof(value) * 1e6);
+    else if (!strcmp(arg, "--max-on")) maxOnSeconds = atof(value);
+    else if (!strcmp(arg, "--max-reagent")) maxReagentMl = atof(value);
+    else if (simBoard.option == nullptr || !simBoard.option(arg, value)) {
+      fprintf(stderr, "unknown option %s\n", arg);
+      return 2;
+    }
+    i++;
+  }
+
+  Plant model(config);
+  plant = &model;
+  board = &simBoard;
+
+  hal::reset(startMs);
+  hal::setSerialEcho(serial);
+  hal::Hooks hooks;
+  hooks.analogRead = onAnalogRead;
+  hooks.digitalRead = onDigitalRead;
+  hooks.pinWritten = onPinWritten;
+  hooks.tick = onTick;
+  hal::setHooks(hooks);
+  bootMicros = lastPlantStep = nextCsv = hal::nowMicros();
+
+  if (csvInterval > 0) {
+    printf("hours,pH,levelCm,temperature,humidity,light,acidMl,baseMl,mistSeconds\n");
+  }
+
+  auto wallStart = std::chrono::steady_clock::now();
+  uint64_t end = bootMicros + (uint64_t)(days * 86400e6);
+  uint64_t passes = 0;
+  uint32_t rollovers = 0;
+  uint32_t lastMillis = millis();
+
+  setup();
+  while (hal::nowMicros() < end) {
+    loop();
+    hal::advance(LOOP_PASS_US);
+    passes++;
+    if (millis() < lastMillis) {
+      rollovers++;
+    }
+    lastMillis = millis();
+  }
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  uint64_t now = hal::nowMicros();
+  int status = 0;
+
+  fprintf(stderr, "%s: %.1f virtual days in %.2f s (%.0fx), %llu loop passes, %u millis() rollovers, %llu serial bytes\n",
+          board->name, days, wall, days * 86400 / fmax(wall, 1e-9), (unsigned long long)passes, rollovers,
+          (unsigned long long)hal::serialBytesWritten());
+  fprintf(stderr, "pH %.2f..%.2f, %.1f%% of the time in 5.5..6.5; acid %.1f ml, base %.1f ml, topped up %.1f L\n",
+          pHMin, pHMax, 100 * inBandSeconds / fmax(totalSeconds, 1e-9), plant->acidMl, plant->baseMl,
+          plant->toppedUpLiters);
+  if (settledSeconds >= 0) {
+    fprintf(stderr, "within %.1f of pH %.1f after %.2f h and %u doses; mean error %.3f\n", SETTLE_BAND, PH_TARGET,
+            settledSeconds / 3600, settledDoses, targetErrorSum / fmax(totalSeconds, 1e-9));
+  } else {
+    fprintf(stderr, "never within %.1f of pH %.1f; mean error %.3f\n", SETTLE_BAND, PH_TARGET,
+            targetErrorSum / fmax(totalSeconds, 1e-9));
+  }
+  fprintf(stderr, "VPD %.1f%% of the time in %.1f..%.1f (%.1f%% above, %.1f%% below); misting %.1f h, %.1f%% duty\n",
+          100 * (totalSeconds - vpdAboveSeconds - vpdBelowSeconds) / fmax(totalSeconds, 1e-9), VPD_BAND_LOW,
+          VPD_BAND_HIGH, 100 * vpdAboveSeconds / fmax(totalSeconds, 1e-9),
+          100 * vpdBelowSeconds / fmax(totalSeconds, 1e-9), plant->mistSeconds / 3600,
+          100 * plant->mistSeconds / fmax(totalSeconds, 1e-9));
+  for (PumpStats& pump : pumps) {
+    if (pump.on) {
+      pump.longestOnSeconds = fmax(pump.longestOnSeconds, (now - pump.onSince) / 1e6);
+    }
+    fprintf(stderr, "  %-5s %6u runs, longest %.1f s\n", pump.name, pump.activations, pump.longestOnSeconds);
+    if (pump.longestOnSeconds > maxOnSeconds) {
+      fprintf(stderr, "FAIL: %s pump stayed on for %.1f s (limit %.0f s)\n", pump.name, pump.longestOnSeconds, maxOnSeconds);
+      status = 1;
+    }
+  }
+  if (reagentOverlaps > 0) {
+    fprintf(stderr, "FAIL: acid and base pumps ran together %u times\n", reagentOverlaps);
+    status = 1;
+  }
+  if (plant->acidMl + plant->baseMl > maxReagentMl) {
+    fprintf(stderr, "FAIL: %.1f ml of acid and base dosed (limit %.0f ml)\n", plant->acidMl + plant->baseMl,
+            maxReagentMl);
+    status = 1;
+  }
+  if (board->pHFault != nullptr && *board->pHFault != expectPHFault) {
+    fprintf(stderr, expectPHFault ? "FAIL: still dosing, no pH fault raised\n" : "FAIL: unexpected pH fault\n");
+    status = 1;
+  }
+  return status;
+}
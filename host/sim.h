@@ -0,0 +1,45 @@
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stdint.h>
+
+// Runs a controller sketch's setup()/loop() against the plant model on the
+// virtual clock. Each board's entry point (sim_ard.cpp, sim_esp8266.cpp)
+// compiles the sketch into the same translation unit and fills in SimBoard
+// from the sketch's own pin and geometry macros.
+
+struct SimBoard {
+  const char* name;
+  uint8_t phPin;
+  uint8_t ldrPin;
+  uint8_t trigPin;
+  uint8_t echoPin;
+  uint8_t vpdRelay;
+  uint8_t acidRelay;
+  uint8_t baseRelay;
+  uint8_t mixRelay;
+  int adcMax;         // Full-scale analogRead() value
+  bool digitalLight;  // LDR module read with digitalRead(), HIGH in light
+  double reservoirRadiusCm;
+  double reservoirHeightCm;
+
+  // Sketch settings for options runSimulation() does not know, e.g.
+  // --ph-mode. Returns false if `name` is not one of them.
+  bool (*option)(const char* name, const char* value);
+
+  // Optional: called every plant step with the virtual time since boot, so a
+  // sketch's entry point can drive it from outside (bridge commands, say)
+  void (*tick)(uint64_t elapsedMicros);
+
+  // The sketch's ControlState::pHFault, checked against --expect-ph-fault
+  const bool* pHFault;
+};
+
+int runSimulation(const SimBoard& board, int argc, char** argv);
+
+// Answer the SHT31 from `plant` outside runSimulation(), as the benchmarks
+// need; NULL detaches it
+class Plant;
+void attachPlant(Plant* plant);
+
+#endif
@@ -0,0 +1,78 @@
+// Uno controller on the simulator
+#include "../ard.cpp"
+#include "sim.h"
+#include "hal.h"
+
+#define MANUAL_REQUEST_INTERVAL 61000000ULL  // us; not a multiple of PH_CHECK_INTERVAL
+
+// --manual-pulse P: ask for a manual pulse of pump P (vpd, acid, base or mix)
+// over the bridge every MANUAL_REQUEST_INTERVAL and whenever an automatic
+// dose starts, as a grower pressing the dashboard button would. A reagent
+// pulse and an automatic dose must never run at the same time.
+static int manualPump = -1;
+static uint8_t manualSequence = 0;
+static uint64_t nextManualRequest = 0;
+static bool wasAdjusting = false;
+static uint32_t manualRequested = 0;
+static uint32_t manualDuringDose = 0;  // Steps in which a reagent pulse and a dose overlapped
+
+static bool sketchOption(const char* name, const char* value) {
+  if (!strcmp(name, "--ph-mode")) {
+    control.pHMode = strcmp(value, "bangbang") ? control.PH_MODE_PI : control.PH_MODE_BANG_BANG;
+    return true;
+  }
+  if (!strcmp(name, "--manual-pulse")) {
+    const char* names[] = {"vpd", "acid", "base", "mix"};
+    for (int i = 0; i < 4; i++) {
+      if (!strcmp(value, names[i])) {
+        manualPump = i;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void requestManualPulse() {
+  uint8_t frame[BRIDGE_MAX_FRAME];
+  size_t length = encodeManualPump(manualSequence++, (BridgePump)manualPump, MANUAL_PULSE_MAX, frame);
+  hal::injectSerial(frame, length);
+  manualRequested++;
+}
+
+static void tick(uint64_t elapsedMicros) {
+  if (manualPump < 0) {
+    return;
+  }
+  bool doseStarted = control.isPHAdjusting && !wasAdjusting;
+  wasAdjusting = control.isPHAdjusting;
+  if (doseStarted) {
+    requestManualPulse();
+  }
+  if (elapsedMicros >= nextManualRequest) {
+    requestManualPulse();
+    nextManualRequest += MANUAL_REQUEST_INTERVAL;
+  }
+  if (control.isPHAdjusting && (pulseActive[PUMP_ACID] || pulseActive[PUMP_BASE])) {
+    manualDuringDose++;
+  }
+}
+
+int main(int argc, char** argv) {
+  SimBoard board = {
+    "ard", Board::phPin, Board::ldrPin, Board::trigPin, Board::echoPin,
+    Board::vpdRelay, Board::acidRelay, Board::baseRelay, Board::mixRelay,
+    Board::adcMax, Board::digitalLight, Board::reservoirRadius, Board::reservoirHeight,
+    sketchOption, tick, &control.pHFault,
+  };
+
+  int status = runSimulation(board, argc, argv);
+  if (manualPump >= 0) {
+    fprintf(stderr, "%u manual pulses requested\n", manualRequested);
+    if (manualDuringDose > 0) {
+      fprintf(stderr, "FAIL: a manual reagent pulse overlapped an automatic dose in %u steps\n", manualDuringDose);
+      status = 1;
+    }
+  }
+  return status;
+}
@@ -0,0 +1,23 @@
+// ESP8266 controller on the simulator
+#define HOST_BOARD_ESP8266  // NodeMCU pin names in Arduino.h
+#include "../esp8266.cpp"
+#include "sim.h"
+
+static bool sketchOption(const char* name, const char* value) {
+  if (!strcmp(name, "--ph-mode")) {
+    control.pHMode = strcmp(value, "bangbang") ? control.PH_MODE_PI : control.PH_MODE_BANG_BANG;
+    return true;
+  }
+  return false;
+}
+
+int main(int argc, char** argv) {
+  SimBoard board = {
+    "esp8266", Board::phPin, Board::ldrPin, Board::trigPin, Board::echoPin,
+    Board::vpdRelay, Board::acidRelay, Board::baseRelay, Board::mixRelay,
+    Board::adcMax, Board::digitalLight, Board::reservoirRadius, Board::reservoirHeight,
+    sketchOption, nullptr, &control.pHFault,
+  };
+
+  return runSimulation(board, argc, argv);
+}
@@ -0,0 +1,211 @@
+#ifndef JOB_SCHEDULER_H
+#define JOB_SCHEDULER_H
+
+#include <Arduino.h>
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+// Cooperative deadline scheduler shared by the controller sketches.
+//
+// Every periodic job is a function that does its work and returns how many ms
+// until it next needs to run. Jobs sit in a small min-heap ordered by deadline,
+// so loop() only calls what is due and can sleep until the earliest deadline.
+// All time math is done on uint32_t so millis() rollover is handled.
+
+#define SCHEDULER_MAX_JOBS 8
+
+typedef uint32_t (*SchedulerJob)(uint32_t currentTime);
+
+// Optional callback after every job run, e.g. to feed timing metrics. `id` is
+// the job's registration order (0 for the first add()).
+typedef void (*SchedulerObserver)(uint8_t id, uint32_t runMicros);
+
+// Milliseconds left until `interval` has passed since `since`, or 0 if it has
+inline uint32_t timeUntil(uint32_t currentTime, uint32_t since, uint32_t interval) {
+  uint32_t elapsed = currentTime - since;
+  return elapsed >= interval ? 0 : interval - elapsed;
+}
+
+class JobScheduler {
+public:
+  // Register a job; the first run happens `firstDelay` ms from now
+  bool add(const char* name, SchedulerJob job, uint32_t firstDelay = 0) {
+    if (count >= SCHEDULER_MAX_JOBS) {
+      return false;
+    }
+    Task& task = tasks[count];
+    task.name = name;
+    task.id = count;
+    task.job = job;
+    task.due = millis() + firstDelay;
+    task.runs = 0;
+    task.maxLateMs = 0;
+    task.maxRunMicros = 0;
+    siftUp(count++);
+    return true;
+  }
+
+  // Run every job whose deadline has passed and return the ms until the next one
+  uint32_t runDue() {
+    uint32_t currentTime = millis();
+    while (count > 0 && !isBefore(currentTime, tasks[0].due)) {
+      SchedulerJob job = tasks[0].job;
+      uint32_t late = currentTime - tasks[0].due;
+
+      uint32_t startMicros = micros();
+      uint32_t next = job(currentTime);
+      uint32_t runMicros = micros() - startMicros;
+
+      // The job may have called runSoon(), so look it up again before rescheduling
+      uint8_t i = indexOf(job);
+      Task& task = tasks[i];
+      if (late > task.maxLateMs) {
+        task.maxLateMs = late;
+      }
+      if (runMicros > task.maxRunMicros) {
+        task.maxRunMicros = runMicros;
+      }
+      task.runs++;
+      if (observer != NULL) {
+        observer(task.id, runMicros);
+      }
+
+      // A job asking for 0 ms would starve the others; 1 ms is the finest tick
+      task.due = currentTime + (next > 0 ? next : 1);
+      siftDown(i);
+      currentTime = millis();
+    }
+    return count > 0 ? msUntil(tasks[0].due, currentTime) : 0;
+  }
+
+  void observe(SchedulerObserver callback) {
+    observer = callback;
+  }
+
+  // Name of the job with registration order `id`, or NULL
+  const char* jobName(uint8_t id) const {
+    for (uint8_t i = 0; i < count; i++) {
+      if (tasks[i].id == id) {
+        return tasks[i].name;
+      }
+    }
+    return NULL;
+  }
+
+  uint8_t jobCount() const {
+    return count;
+  }
+
+  // Pull a job's deadline forward to now, e.g. after a setpoint change
+  void runSoon(SchedulerJob job) {
+    uint8_t i = indexOf(job);
+    if (i < count) {
+      tasks[i].due = millis();
+      siftUp(i);
+    }
+  }
+
+  // Sleep for `ms`, normally the value returned by runDue()
+  void idle(uint32_t ms) {
+    if (ms == 0) {
+      return;
+    }
+#if defined(__AVR__)
+    // Idle sleep stops the CPU clock; the Timer0 tick wakes it every ms
+    uint32_t start = millis();
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (millis() - start < ms) {
+      sleep_mode();
+    }
+#else
+    delay(ms);  // Yields to the WiFi stack / FreeRTOS idle task
+#endif
+  }
+
+  // Dump the job table: next deadline, run count and worst lateness/run time.
+  // About 60 bytes a job, so on a slow UART the caller should pick its moment.
+  void print(Print& out) {
+    uint32_t currentTime = millis();
+    out.println(F("Job          due(ms)  runs  maxLate(ms)  maxRun(us)"));
+    for (uint8_t i = 0; i < count; i++) {
+      char line[64];
+      snprintf_P(line, sizeof(line), PSTR("%-12s %7lu %5lu %12lu %11lu"),
+               tasks[i].name,
+               (unsigned long)msUntil(tasks[i].due, currentTime),
+               (unsigned long)tasks[i].runs,
+               (unsigned long)tasks[i].maxLateMs,
+               (unsigned long)tasks[i].maxRunMicros);
+      out.println(line);
+    }
+  }
+
+private:
+  struct Task {
+    const char* name;
+    uint8_t id;
+    SchedulerJob job;
+    uint32_t due;
+    uint32_t runs;
+    uint32_t maxLateMs;
+    uint32_t maxRunMicros;
+  };
+
+  static bool isBefore(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+  }
+
+  static uint32_t msUntil(uint32_t due, uint32_t currentTime) {
+    return isBefore(currentTime, due) ? due - currentTime : 0;
+  }
+
+  uint8_t indexOf(SchedulerJob job) const {
+    uint8_t i = 0;
+    while (i < count && tasks[i].job != job) {
+      i++;
+    }
+    return i;
+  }
+
+  void swap(uint8_t a, uint8_t b) {
+    Task tmp = tasks[a];
+    tasks[a] = tasks[b];
+    tasks[b] = tmp;
+  }
+
+  void siftUp(uint8_t i) {
+    while (i > 0) {
+      uint8_t parent = (i - 1) / 2;
+      if (!isBefore(tasks[i].due, tasks[parent].due)) {
+        break;
+      }
+      swap(i, parent);
+      i = parent;
+    }
+  }
+
+  void siftDown(uint8_t i) {
+    for (;;) {
+      uint8_t left = 2 * i + 1;
+      uint8_t right = left + 1;
+      uint8_t earliest = i;
+      if (left < count && isBefore(tasks[left].due, tasks[earliest].due)) {
+        earliest = left;
+      }
+      if (right < count && isBefore(tasks[right].due, tasks[earliest].due)) {
+        earliest = right;
+      }
+      if (earliest == i) {
+        break;
+      }
+      swap(i, earliest);
+      i = earliest;
+    }
+  }
+
+  Task tasks[SCHEDULER_MAX_JOBS];
+  uint8_t count = 0;
+  SchedulerObserver observer = NULL;
+};
+
+#endif
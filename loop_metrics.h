@@ -0,0 +1,153 @@
+#ifndef LOOP_METRICS_H
+#define LOOP_METRICS_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// Timing statistics for the control loop and the web server, rendered in the
+// Prometheus text format.
+//
+// A TimingStat takes durations in microseconds. It keeps cumulative histogram
+// buckets plus a sum and a count, which Prometheus turns into rates and
+// quantiles. It also keeps the min/avg/max since the last scrape, which shows
+// a one-off stall that a rate would average away. Recording is a few compares
+// and adds, cheap enough to run on every loop() pass.
+//
+// Not thread-safe; the owner serializes record() against take().
+
+// Histogram bucket bounds in microseconds; the +Inf bucket is implicit
+static const uint32_t METRICS_BUCKETS_US[] = {
+  50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000,
+};
+#define METRICS_BUCKET_COUNT (sizeof(METRICS_BUCKETS_US) / sizeof(METRICS_BUCKETS_US[0]))
+
+struct TimingStat {
+  uint32_t buckets[METRICS_BUCKET_COUNT + 1] = {};  // Per bucket, not cumulative; the last is +Inf
+  uint64_t sumMicros = 0;
+  uint32_t count = 0;
+
+  // Since the last take()
+  uint32_t windowCount = 0;
+  uint32_t windowMin = 0;
+  uint32_t windowMax = 0;
+  uint64_t windowSum = 0;
+
+  void record(uint32_t micros) {
+    uint8_t i = 0;
+    while (i < METRICS_BUCKET_COUNT && micros > METRICS_BUCKETS_US[i]) {
+      i++;
+    }
+    buckets[i]++;
+    sumMicros += micros;
+    count++;
+
+    if (windowCount == 0 || micros < windowMin) {
+      windowMin = micros;
+    }
+    if (micros > windowMax) {
+      windowMax = micros;
+    }
+    windowSum += micros;
+    windowCount++;
+  }
+
+  // Copy the stat out and start a new min/avg/max window
+  TimingStat take() {
+    TimingStat copy = *this;
+    windowCount = 0;
+    windowMin = 0;
+    windowMax = 0;
+    windowSum = 0;
+    return copy;
+  }
+};
+
+// Writes metrics into a fixed buffer and hands it to `flush` whenever it runs
+// low, so a scrape of any size goes out in chunks from a small stack buffer.
+class MetricsWriter {
+public:
+  typedef void (*Flush)(const char* text, size_t length);
+
+  MetricsWriter(char* buffer, size_t size, Flush flush) : buffer(buffer), size(size), flush(flush) {}
+
+  __attribute__((format(printf, 2, 3))) void printf(const char* format, ...) {
+    // No single line is longer than this; flush first so it always fits
+    if (size - length < 160) {
+      finish();
+    }
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer + length, size - length, format, args);
+    va_end(args);
+    if (n > 0) {
+      length = min(length + n, size - 1);
+    }
+  }
+
+  // HELP and TYPE lines; once per metric name, before its samples
+  void describe(const char* name, const char* type, const char* help) {
+    printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+  }
+
+  void gauge(const char* name, const char* labels, double value) {
+    printf("%s%s %.6g\n", name, labels, value);
+  }
+
+  // `name` is a histogram in seconds. `labels` is "" or like {job="ph"}; the
+  // bucket lines add le to it.
+  void histogram(const char* name, const char* labels, const TimingStat& stat) {
+    char inner[48];
+    innerLabels(labels, inner, sizeof(inner));
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < METRICS_BUCKET_COUNT; i++) {
+      cumulative += stat.buckets[i];
+      printf("%s_bucket{%sle=\"%.6g\"} %lu\n", name, inner, METRICS_BUCKETS_US[i] / 1e6,
+             (unsigned long)cumulative);
+    }
+    cumulative += stat.buckets[METRICS_BUCKET_COUNT];
+    printf("%s_bucket{%sle=\"+Inf\"} %lu\n", name, inner, (unsigned long)cumulative);
+    printf("%s_sum%s %.6f\n", name, labels, stat.sumMicros / 1e6);
+    printf("%s_count%s %lu\n", name, labels, (unsigned long)stat.count);
+  }
+
+  // The window's min/avg/max as <name>_window_seconds{stat="min"} etc.
+  void describeWindow(const char* name, const char* help) {
+    printf("# HELP %s_window_seconds %s, min/avg/max since the last scrape\n"
+           "# TYPE %s_window_seconds gauge\n", name, help, name);
+  }
+
+  void window(const char* name, const char* labels, const TimingStat& stat) {
+    char inner[48];
+    innerLabels(labels, inner, sizeof(inner));
+    double avg = stat.windowCount > 0 ? (double)stat.windowSum / stat.windowCount : 0.0;
+    printf("%s_window_seconds{%sstat=\"min\"} %.6f\n", name, inner, stat.windowMin / 1e6);
+    printf("%s_window_seconds{%sstat=\"avg\"} %.6f\n", name, inner, avg / 1e6);
+    printf("%s_window_seconds{%sstat=\"max\"} %.6f\n", name, inner, stat.windowMax / 1e6);
+  }
+
+  // Send whatever is buffered
+  void finish() {
+    if (length > 0) {
+      flush(buffer, length);
+      length = 0;
+    }
+  }
+
+private:
+  // {job="ph"} -> job="ph", so more labels can follow inside the braces
+  static void innerLabels(const char* labels, char* out, size_t outSize) {
+    size_t n = strlen(labels);
+    if (n < 2) {
+      out[0] = '\0';
+      return;
+    }
+    snprintf(out, outSize, "%.*s,", (int)(n - 2), labels + 1);
+  }
+
+  char* buffer;
+  size_t size;
+  size_t length = 0;
+  Flush flush;
+};
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef SENSOR_SAMPLER_H
+#define SENSOR_SAMPLER_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "Adafruit_SHT31.h"
+#include "adc_filter.h"
+#include "control_core.h"
+#include "echo_capture.h"
+#include "sensor_snapshot.h"
+
+// Reads one reservoir's sensors, each at its own rate, into a snapshot. Used
+// by every controller: directly by the Uno and ESP8266 sketches, through
+// BoardZone (zone.h) on the ESP32. Built from a board profile (control_core.h)
+// with two more members
+//
+//   sht31Address     0x44, or 0x45 with ADDR pulled high
+//   i2cMuxChannel    TCA9548A channel the SHT31 is behind, NO_MUX if none
+//
+// pH and an analog LDR go through AdcFilters. A sketch with a continuous ADC
+// feeds them with pushAdc(); otherwise the sampler burst-reads the probe
+// itself when a sample is due.
+
+#define CLIMATE_SAMPLE_INTERVAL 2000
+#define PH_SAMPLE_INTERVAL 1000
+#define LEVEL_SAMPLE_INTERVAL 5000
+#define LIGHT_SAMPLE_INTERVAL 1000
+#define PH_OVERSAMPLE 8  // analogRead()s per pH sample without a continuous ADC
+
+#define NO_MUX 0xFF
+#define I2C_MUX_ADDRESS 0x70
+
+template <class Board>
+class SensorSampler {
+  typedef EchoCapture<Board::trigPin, Board::echoPin> LevelSensor;
+  static_assert(Board::sht31Address == 0x44 || Board::sht31Address == 0x45, "SHT31 is at 0x44 or 0x45");
+  static_assert(Board::i2cMuxChannel == NO_MUX || Board::i2cMuxChannel < 8, "TCA9548A has channels 0-7");
+
+public:
+  explicit SensorSampler(SensorSnapshot& snapshot) : snapshot(snapshot) {}
+
+  // False if the SHT31 did not answer
+  bool begin() {
+    // Allow a few cm past the tank floor so an empty tank still reads
+    LevelSensor::begin(Board::reservoirHeight + 5.0);
+    if (Board::digitalLight) {
+      pinMode(Board::ldrPin, INPUT);
+    }
+    selectMux();
+    return sht31.begin(Board::sht31Address);
+  }
+
+  // Read whichever sensors are due into the snapshot; true if it changed.
+  // The SHT31 read blocks for tens of ms, so it only happens when
+  // `climateAllowed`, and `climateRead` says whether it did.
+  bool sample(uint32_t currentTime, bool climateAllowed, bool& climateRead) {
+    bool updated = false;
+    climateRead = false;
+
+    if (climateAllowed && climateChannel.isDue(currentTime)) {
+      float t, h;
+      selectMux();
+      snapshot.climateValid = sht31.readBoth(&t, &h);
+      snapshot.temperature = snapshot.climateValid ? t : NAN;
+      snapshot.humidity = snapshot.climateValid ? h : NAN;
+      snapshot.vpd = calculateVPD(snapshot.temperature, snapshot.humidity);
+      climateChannel.markSampled(currentTime);
+      climateRead = true;
+      updated = true;
+    }
+
+    if (phChannel.isDue(currentTime)) {
+      snapshot.pH = readPH();
+      phChannel.markSampled(currentTime);
+      updated = true;
+    }
+
+    // The ping is timed by the echo interrupt; its result is picked up on a
+    // later pass instead of blocking in pulseIn()
+    if (levelChannel.isDue(currentTime) && !LevelSensor::inFlight()) {
+      LevelSensor::trigger();
+      levelChannel.markSampled(currentTime);
+    }
+    float distance;
+    if (LevelSensor::poll(distance)) {
+      snapshot.waterLevel = max(0.0f, Board::reservoirHeight - distance);
+      snapshot.reservoirVolume = ControlCore<Board>::reservoirVolume(snapshot.waterLevel);
+      updated = true;
+    }
+
+    if (lightChannel.isDue(currentTime)) {
+      snapshot.lightIntensity = readLight();
+      lightChannel.markSampled(currentTime);
+      updated = true;
+    }
+
+    if (updated) {
+      snapshot.sequence++;
+      snapshot.timestamp = currentTime;
+    }
+    return updated;
+  }
+
+  uint32_t msUntilDue(uint32_t currentTime) const {
+    uint32_t next = climateChannel.msUntilDue(currentTime);
+    next = min(next, phChannel.msUntilDue(currentTime));
+    next = min(next, levelChannel.msUntilDue(currentTime));
+    next = min(next, lightChannel.msUntilDue(currentTime));
+    if (LevelSensor::inFlight()) {
+      next = min(next, (uint32_t)ECHO_POLL_INTERVAL);
+    }
+    return next;
+  }
+
+  // A raw conversion from the sketch's ADC; ignored unless the pin is ours
+  void pushAdc(uint8_t pin, uint16_t raw) {
+    if (pin == Board::phPin) {
+      phFilter.push(raw);
+      phFed = true;
+    } else if (pin == Board::ldrPin) {
+      lightFilter.push(raw);
+      lightFed = true;
+    }
+  }
+
+  // The filtered probe reading, scaled. Without conversions pushed since the
+  // last sample, burst-read the probe so pH is not quantized to whole counts.
+  float readPH() {
+    if (!phFed) {
+      for (uint8_t i = 0; i < PH_OVERSAMPLE; i++) {
+        phFilter.push(analogRead(Board::phPin));
+      }
+    }
+    phFed = false;
+    return ControlCore<Board>::pHFromAdc(phFilter.value());
+  }
+
+private:
+  int readLight() {
+    if (Board::digitalLight) {
+      return digitalRead(Board::ldrPin);
+    }
+    if (!lightFed) {
+      return analogRead(Board::ldrPin);
+    }
+    lightFed = false;
+    return (int)lightFilter.value();
+  }
+
+  // Route the bus to this sensor's SHT31. Every sampler selects before each
+  // access, so whatever another one left selected does not matter.
+  static void selectMux() {
+    if (Board::i2cMuxChannel == NO_MUX) {
+      return;
+    }
+    Wire.beginTransmission(I2C_MUX_ADDRESS);
+    Wire.write(1 << (Board::i2cMuxChannel % 8));  // In range, see the static_assert
+    Wire.endTransmission();
+  }
+
+  SensorSnapshot& snapshot;
+  Adafruit_SHT31 sht31;
+  SampleChannel climateChannel{CLIMATE_SAMPLE_INTERVAL};
+  SampleChannel phChannel{PH_SAMPLE_INTERVAL};
+  SampleChannel levelChannel{LEVEL_SAMPLE_INTERVAL};
+  SampleChannel lightChannel{LIGHT_SAMPLE_INTERVAL};
+  AdcFilter<16> phFilter;
+  AdcFilter<16> lightFilter;
+  bool phFed = false;     // Conversions pushed since the last pH sample
+  bool lightFed = false;
+};
+
+#endif
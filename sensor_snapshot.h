@@ -0,0 +1,47 @@
+#ifndef SENSOR_SNAPSHOT_H
+#define SENSOR_SNAPSHOT_H
+
+#include <Arduino.h>
+
+// Latest reading of every sensor, published by the sampler job. The control
+// handlers and the web pages read from here instead of touching the hardware,
+// so each sensor is only read at its own sample rate.
+struct SensorSnapshot {
+  uint32_t sequence = 0;    // Bumped on every publish
+  uint32_t timestamp = 0;   // millis() of the publish
+  bool climateValid = false;
+  float temperature = NAN;
+  float humidity = NAN;
+  float vpd = NAN;
+  float pH = 0.0;
+  float waterLevel = 0.0;
+  float reservoirVolume = 0.0;
+  int lightIntensity = 0;
+};
+
+// One sensor owned by the sampler: how often it is read and when it last was
+struct SampleChannel {
+  uint32_t interval;
+  uint32_t lastSample;
+  bool sampled;
+
+  explicit SampleChannel(uint32_t interval) : interval(interval), lastSample(0), sampled(false) {}
+
+  bool isDue(uint32_t currentTime) const {
+    return !sampled || currentTime - lastSample >= interval;
+  }
+
+  void markSampled(uint32_t currentTime) {
+    lastSample = currentTime;
+    sampled = true;
+  }
+
+  uint32_t msUntilDue(uint32_t currentTime) const {
+    if (isDue(currentTime)) {
+      return 0;
+    }
+    return interval - (currentTime - lastSample);
+  }
+};
+
+#endif
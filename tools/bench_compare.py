@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Compare a Google Benchmark JSON run against the checked-in baseline.
+
+Usage: tools/bench_compare.py host/bench_baseline.json host/bench_results.json
+
+Fails if any benchmark allocates more per iteration than the baseline does,
+or if its fastest repetition takes twice as long (ns/op) as the baseline's
+fastest. The minimum is what a run gets without interference from the rest
+of the machine, so it moves far less between runs than a median or a single
+run does, but on a shared VM it still wanders by up to a third. Slowdowns
+past 25% are flagged SLOWER without failing the run; look at them, rerun,
+and treat ones that persist as regressions. Timings are only comparable on the same machine; refresh
+the baseline with `make -C host bench-baseline` after an intended change or
+when moving to a different machine.
+"""
+import json
+import sys
+
+WARN_SLOWDOWN = 1.25
+MAX_SLOWDOWN = 2.0
+
+
+def load(path):
+    # The fastest repetition of each benchmark. Needs the individual runs in
+    # the JSON, i.e. --benchmark_display_aggregates_only rather than
+    # --benchmark_report_aggregates_only.
+    with open(path, encoding="utf-8") as f:
+        runs = json.load(f)["benchmarks"]
+    fastest = {}
+    for run in runs:
+        if run.get("run_type") != "iteration":
+            continue
+        name = run.get("run_name", run["name"])
+        if name not in fastest or run["cpu_time"] < fastest[name]["cpu_time"]:
+            fastest[name] = run
+    return fastest
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    baseline, current = load(sys.argv[1]), load(sys.argv[2])
+
+    failed = False
+    print("%-32s %12s %12s %8s %10s" % ("benchmark", "base min ns", "min ns", "change", "allocs/op"))
+    for name, run in current.items():
+        base = baseline.get(name)
+        if base is None:
+            print("%-32s %12s %12.1f %8s %10.2f" % (name, "-", run["cpu_time"], "new", run.get("allocs/op", 0)))
+            continue
+        ratio = run["cpu_time"] / base["cpu_time"]
+        allocs, baseAllocs = run.get("allocs/op", 0), base.get("allocs/op", 0)
+        flags = []
+        if ratio > MAX_SLOWDOWN:
+            flags.append("REGRESSED")
+            failed = True
+        elif ratio > WARN_SLOWDOWN:
+            flags.append("SLOWER")
+        if allocs > baseAllocs:
+            flags.append("ALLOCATES")
+            failed = True
+        print("%-32s %12.1f %12.1f %+7.0f%% %10.2f %s" % (
+            name, base["cpu_time"], run["cpu_time"], (ratio - 1) * 100, allocs, " ".join(flags)))
+    for name in baseline.keys() - current.keys():
+        print("%-32s missing from this run" % name)
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
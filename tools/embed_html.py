@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""Minify and gzip a dashboard page into a PROGMEM header for the sketches.
+
+Usage: tools/embed_html.py web/esp32_dashboard.html esp32_dashboard_html.h ESP32_DASHBOARD
+
+Writes <NAME>_GZ / <NAME>_GZ_LEN with the gzipped page and <NAME>_ETAG, a
+hash of the page content, so the firmware can answer If-None-Match with 304
+until the page actually changes. Re-run after editing anything under web/.
+"""
+import gzip
+import hashlib
+import os
+import sys
+
+
+def minify(html):
+    # Indentation, blank lines and whole-line // comments only; the pages have
+    # no multi-line strings that this could break
+    lines = (line.strip() for line in html.splitlines())
+    return "\n".join(line for line in lines if line and not line.startswith("//"))
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit(__doc__)
+    src, dst, name = sys.argv[1:]
+
+    with open(src, encoding="utf-8") as f:
+        page = minify(f.read()).encode("utf-8")
+    # mtime=0 keeps the output identical between runs
+    packed = gzip.compress(page, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(page).hexdigest()[:16]
+
+    guard = os.path.basename(dst).upper().replace(".", "_")
+    out = [
+        "// Generated by tools/embed_html.py from %s - do not edit" % src,
+        "// %d bytes minified, %d bytes gzipped" % (len(page), len(packed)),
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "#include <Arduino.h>",
+        "",
+        '#define %s_ETAG "\\"%s\\""' % (name, etag),
+        "",
+        "const size_t %s_GZ_LEN = %d;" % (name, len(packed)),
+        "const uint8_t %s_GZ[] PROGMEM = {" % name,
+    ]
+    for i in range(0, len(packed), 16):
+        out.append("  " + ", ".join("0x%02x" % b for b in packed[i:i + 16]) + ",")
+    out += ["};", "", "#endif", ""]
+
+    with open(dst, "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
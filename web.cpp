@@ -2,6 +2,8 @@
 #include <ESP8266WebServer.h>
 #include <ArduinoJson.h>
 #include <SoftwareSerial.h>
+#include "bridge_dashboard_html.h"
+#include "bridge_protocol.h"
 
 const char* ssid = "Tbag";
 const char* password = "Dbcooper";
@@ -9,15 +11,27 @@ const char* password = "Dbcooper";
 ESP8266WebServer server(80);
 SoftwareSerial arduinoSerial(D1, D2); // RX, TX
 
-struct SensorData {
-  float temperature;
-  float humidity;
-  float vpd;
-  float pH;
-  float waterLevel;
-  float reservoirVolume;
-  int lightIntensity;
-} sensorData;
+#define MANUAL_PUMP_DURATION 2000  // ms a manual pump button runs the pump for
+#define COMMAND_TRACK 8             // Commands in flight whose send time is kept for the RTT
+
+SensorData sensorData;
+FrameAssembler arduinoFrames;
+
+// Command sequence numbers and their send times, matched against the ACKs
+uint8_t nextCommandSequence = 0;
+unsigned long commandSentAt[COMMAND_TRACK];
+unsigned long lastCommandRtt = 0;
+unsigned long maxCommandRtt = 0;
+uint32_t commandsAcked = 0;
+
+// Function declarations
+void handleRoot();
+void handleData();
+void handleControl();
+void handleFrame();
+void sendFrame(const uint8_t* frame, size_t frameLength);
+uint8_t beginCommand();
+void handleAck(const uint8_t* payload, uint8_t length);
 
 void setup() {
   Serial.begin(115200);
@@ -35,179 +49,75 @@ void setup() {
   server.on("/", handleRoot);
   server.on("/data", handleData);
   server.on("/control", handleControl);
+  const char* headerKeys[] = {"If-None-Match"};
+  server.collectHeaders(headerKeys, 1);
   server.begin();
 }
 
 void loop() {
   server.handleClient();
-  if (arduinoSerial.available()) {
-    String jsonStr = arduinoSerial.readStringUntil('\n');
-    DynamicJsonDocument doc(1024);
-    DeserializationError error = deserializeJson(doc, jsonStr);
-    if (error) {
-      Serial.print(F("deserializeJson() failed: "));
-      Serial.println(error.f_str());
-      return;
+
+  // Only take the bytes already received; a frame still on the wire is
+  // finished on a later pass instead of blocking handleClient()
+  int received = arduinoSerial.available();
+  while (received-- > 0) {
+    if (arduinoFrames.push(arduinoSerial.read())) {
+      handleFrame();
     }
-    sensorData.temperature = doc["temperature"];
-    sensorData.humidity = doc["humidity"];
-    sensorData.vpd = doc["vpd"];
-    sensorData.pH = doc["pH"];
-    sensorData.waterLevel = doc["waterLevel"];
-    sensorData.reservoirVolume = doc["reservoirVolume"];
-    sensorData.lightIntensity = doc["lightIntensity"];
   }
 }
 
+void handleFrame() {
+  switch (arduinoFrames.type()) {
+    case FRAME_TELEMETRY:
+      decodeTelemetry(arduinoFrames.payload(), arduinoFrames.payloadLength(), sensorData);
+      break;
+    case FRAME_ACK:
+      handleAck(arduinoFrames.payload(), arduinoFrames.payloadLength());
+      break;
+  }
+}
+
+// Take the next sequence number for a command and note when it went out
+uint8_t beginCommand() {
+  uint8_t sequence = nextCommandSequence++;
+  commandSentAt[sequence % COMMAND_TRACK] = millis();
+  return sequence;
+}
+
+void handleAck(const uint8_t* payload, uint8_t length) {
+  if (length < 3) {
+    return;
+  }
+  uint8_t sequence = payload[0];
+  // Only ACKs for one of the last COMMAND_TRACK commands can be timed
+  uint8_t age = nextCommandSequence - sequence;
+  if (age == 0 || age > COMMAND_TRACK) {
+    return;
+  }
+  lastCommandRtt = millis() - commandSentAt[sequence % COMMAND_TRACK];
+  maxCommandRtt = max(maxCommandRtt, lastCommandRtt);
+  commandsAcked++;
+  if (payload[2] != ACK_OK) {
+    Serial.printf("Command 0x%02x rejected by Arduino (status %u)\n", payload[1], payload[2]);
+  }
+}
+
+void sendFrame(const uint8_t* frame, size_t frameLength) {
+  arduinoSerial.write(frame, frameLength);
+}
+
+// Gzipped page from flash with a content-hash ETag; see tools/embed_html.py
 void handleRoot() {
-  String html = R"rawliteral(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>Aeroponic Control Panel</title>
-    <style>
-        body {
-            font-family: Arial, sans-serif;
-            background: linear-gradient(120deg, #84fab0 0%, #8fd3f4 100%);
-            margin: 0;
-            padding: 20px;
-            color: #333;
-        }
-        .container {
-            max-width: 800px;
-            margin: 0 auto;
-            background-color: rgba(255, 255, 255, 0.9);
-            border-radius: 10px;
-            padding: 20px;
-            box-shadow: 0 0 10px rgba(0,0,0,0.1);
-        }
-        h1 {
-            color: #2c3e50;
-            text-align: center;
-        }
-        .sensor-grid {
-            display: grid;
-            grid-template-columns: repeat(auto-fit, minmax(200px, 1fr));
-            gap: 20px;
-            margin-bottom: 20px;
-        }
-        .sensor-card {
-            background-color: #fff;
-            border-radius: 5px;
-            padding: 15px;
-            text-align: center;
-            box-shadow: 0 2px 5px rgba(0,0,0,0.1);
-        }
-        .sensor-value {
-            font-size: 24px;
-            font-weight: bold;
-            margin: 10px 0;
-        }
-        .controls {
-            display: flex;
-            flex-wrap: wrap;
-            justify-content: space-around;
-        }
-        .control-item {
-            margin: 10px;
-        }
-        input[type="range"] {
-            width: 200px;
-        }
-        button {
-            background-color: #3498db;
-            color: white;
-            border: none;
-            padding: 10px 20px;
-            border-radius: 5px;
-            cursor: pointer;
-            transition: background-color 0.3s;
-        }
-        button:hover {
-            background-color: #2980b9;
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>Aeroponic Control Panel</h1>
-        <div class="sensor-grid" id="sensorGrid"></div>
-        <div class="controls">
-            <div class="control-item">
-                <label for="lightThreshold">Light Threshold:</label>
-                <input type="range" id="lightThreshold" min="0" max="1023" value="300">
-                <span id="lightThresholdValue">300</span>
-            </div>
-            <div class="control-item">
-                <label for="pHTarget">pH Target:</label>
-                <input type="range" id="pHTarget" min="5.5" max="6.5" step="0.1" value="6.0">
-                <span id="pHTargetValue">6.0</span>
-            </div>
-            <div class="control-item">
-                <button onclick="manualPump('vpd')">VPD Pump</button>
-                <button onclick="manualPump('acid')">Acid Pump</button>
-                <button onclick="manualPump('base')">Base Pump</button>
-            </div>
-        </div>
-    </div>
-    <script>
-        function updateSensorData() {
-            fetch('/data')
-                .then(response => response.json())
-                .then(data => {
-                    const sensorGrid = document.getElementById('sensorGrid');
-                    sensorGrid.innerHTML = '';
-                    for (const [key, value] of Object.entries(data)) {
-                        const card = document.createElement('div');
-                        card.className = 'sensor-card';
-                        card.innerHTML = `
-                            <h3>${key.replace(/([A-Z])/g, ' $1').trim()}</h3>
-                            <div class="sensor-value">${value}</div>
-                        `;
-                        sensorGrid.appendChild(card);
-                    }
-                });
-        }
-
-        function updateControl(control, value) {
-            fetch('/control', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/json',
-                },
-                body: JSON.stringify({ [control]: value }),
-            });
-        }
-
-        function manualPump(pump) {
-            fetch('/control', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/json',
-                },
-                body: JSON.stringify({ manualPump: pump }),
-            });
-        }
-
-        document.getElementById('lightThreshold').addEventListener('input', function() {
-            document.getElementById('lightThresholdValue').textContent = this.value;
-            updateControl('lightThreshold', this.value);
-        });
-
-        document.getElementById('pHTarget').addEventListener('input', function() {
-            document.getElementById('pHTargetValue').textContent = this.value;
-            updateControl('pHTarget', this.value);
-        });
-
-        setInterval(updateSensorData, 5000);
-        updateSensorData();
-    </script>
-</body>
-</html>
-)rawliteral";
-  server.send(200, "text/html", html);
+  server.sendHeader("ETag", BRIDGE_DASHBOARD_ETAG);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (server.header("If-None-Match") == BRIDGE_DASHBOARD_ETAG) {
+    server.send(304);
+    return;
+  }
+
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (PGM_P)BRIDGE_DASHBOARD_GZ, BRIDGE_DASHBOARD_GZ_LEN);
 }
 
 void handleData() {
@@ -219,30 +129,58 @@ void handleData() {
   doc["WaterLevel"] = String(sensorData.waterLevel, 1) + " cm";
   doc["ReservoirVolume"] = String(sensorData.reservoirVolume, 1) + " L";
   doc["LightIntensity"] = String(sensorData.lightIntensity);
+  if (sensorData.flags & SENSOR_PH_FAULT) {
+    doc["pHFault"] = "Dosing stopped, check the probe";
+  }
+  if (commandsAcked > 0) {
+    doc["CommandLatency"] = String(lastCommandRtt) + " ms (max " + String(maxCommandRtt) + ")";
+  }
 
   String jsonString;
   serializeJson(doc, jsonString);
   server.send(200, "application/json", jsonString);
 }
 
+// The dashboards post slider values as strings, e.g. {"pHTarget":"6.2"}
+float controlNumber(JsonVariantConst value) {
+  return value.is<const char*>() ? atof(value.as<const char*>()) : value.as<float>();
+}
+
 void handleControl() {
   if (server.hasArg("plain")) {
     String message;
     DynamicJsonDocument doc(1024);
     deserializeJson(doc, server.arg("plain"));
     
+    uint8_t frame[BRIDGE_MAX_FRAME];
     if (doc.containsKey("lightThreshold")) {
-      int lightThreshold = doc["lightThreshold"];
+      int lightThreshold = controlNumber(doc["lightThreshold"]);
       message = "Light threshold set to: " + String(lightThreshold);
-      arduinoSerial.println("LT:" + String(lightThreshold));
+      sendFrame(frame, encodeLightThreshold(beginCommand(), lightThreshold, frame));
     } else if (doc.containsKey("pHTarget")) {
-      float pHTarget = doc["pHTarget"];
+      float pHTarget = controlNumber(doc["pHTarget"]);
       message = "pH target set to: " + String(pHTarget);
-      arduinoSerial.println("PT:" + String(pHTarget));
+      sendFrame(frame, encodePHTarget(beginCommand(), pHTarget, frame));
     } else if (doc.containsKey("manualPump")) {
       String pump = doc["manualPump"];
+      BridgePump id;
+      if (pump == "vpd") {
+        id = PUMP_VPD;
+      } else if (pump == "acid") {
+        id = PUMP_ACID;
+      } else if (pump == "base") {
+        id = PUMP_BASE;
+      } else if (pump == "mix") {
+        id = PUMP_MIX;
+      } else {
+        server.send(400, "text/plain", "Unknown pump: " + pump);
+        return;
+      }
       message = "Manual pump activated: " + pump;
-      arduinoSerial.println("MP:" + pump);
+      sendFrame(frame, encodeManualPump(beginCommand(), id, MANUAL_PUMP_DURATION, frame));
+    } else if (doc.containsKey("resetPHFault")) {
+      message = "pH fault reset";
+      sendFrame(frame, encodeResetPHFault(beginCommand(), frame));
     }
     
     server.send(200, "text/plain", message);
@@ -0,0 +1,158 @@
+#ifndef ZONE_H
+#define ZONE_H
+
+#include <Arduino.h>
+#include <AccelStepper.h>
+#include "control_core.h"
+#include "sensor_sampler.h"
+#include "sensor_snapshot.h"
+
+// One reservoir and its tower: sensors, stepper and control core, built from
+// a board profile as sensor_sampler.h describes it. Two SHT31s share the bus
+// by address; past that each zone's sensor sits on its own mux channel. The
+// controller keeps its zones as Zone pointers so one scheduler, sampler job
+// and web server serve all of them; everything typed on the profile (pins,
+// ADC scaling, the echo ISR) stays behind the virtual calls.
+//
+// pH and LDR readings arrive from the sketch's continuous ADC through
+// pushAdc(); without it the sampler reads the pins itself.
+
+template <class Board>
+constexpr bool pinFreeIn(uint8_t pin) {
+  return pinNotIn(pin, Board::phPin, Board::ldrPin, Board::vpdRelay, Board::acidRelay, Board::baseRelay,
+                  Board::mixRelay, Board::trigPin, Board::echoPin, Board::stepPin, Board::dirPin);
+}
+
+// True if two zones' SHT31s never answer at the same address. A sensor
+// outside the mux is on the bus whatever channel is selected, so two sensors
+// can share an address only if both sit behind the mux, on different channels.
+template <class A, class B>
+constexpr bool sht31sApart() {
+  return A::sht31Address != B::sht31Address ||
+         (A::i2cMuxChannel != NO_MUX && B::i2cMuxChannel != NO_MUX && A::i2cMuxChannel != B::i2cMuxChannel);
+}
+
+// True if two zone profiles can run side by side: no shared pin apart from
+// the I2C bus, and SHT31s that are apart as above
+template <class A, class B>
+constexpr bool zonesApart() {
+  return pinFreeIn<B>(A::phPin) && pinFreeIn<B>(A::ldrPin) && pinFreeIn<B>(A::vpdRelay) &&
+         pinFreeIn<B>(A::acidRelay) && pinFreeIn<B>(A::baseRelay) && pinFreeIn<B>(A::mixRelay) &&
+         pinFreeIn<B>(A::trigPin) && pinFreeIn<B>(A::echoPin) && pinFreeIn<B>(A::stepPin) &&
+         pinFreeIn<B>(A::dirPin) && sht31sApart<A, B>();
+}
+
+// The four-zone layout the mux is for: two SHT31s at 0x44 on mux channels
+// 0 and 1 beside one at 0x45 outside it, and what the check must reject
+namespace zone_layout_check {
+template <uint8_t Address, uint8_t Channel>
+struct Sht31At {
+  static constexpr uint8_t sht31Address = Address;
+  static constexpr uint8_t i2cMuxChannel = Channel;
+};
+static_assert(sht31sApart<Sht31At<0x44, 0>, Sht31At<0x44, 1>>(), "Same address on two mux channels");
+static_assert(sht31sApart<Sht31At<0x44, 0>, Sht31At<0x45, NO_MUX>>(), "Mux zone beside a direct one");
+static_assert(!sht31sApart<Sht31At<0x44, 2>, Sht31At<0x44, 2>>(), "Same address on one channel");
+static_assert(!sht31sApart<Sht31At<0x44, 0>, Sht31At<0x44, NO_MUX>>(), "Direct sensor answers on every channel");
+}  // namespace zone_layout_check
+
+class Zone {
+public:
+  Zone(const char* name, ControlState& control) : name(name), control(control) {}
+
+  virtual void begin() = 0;
+
+  // Read whichever sensors are due into the snapshot; true if it changed.
+  // The SHT31 read blocks for tens of ms, so it only happens when
+  // `climateAllowed`, and `climateRead` says whether it did.
+  virtual bool sample(uint32_t currentTime, bool climateAllowed, bool& climateRead) = 0;
+  virtual uint32_t msUntilDue(uint32_t currentTime) = 0;
+
+  // A raw conversion from the sketch's ADC; ignored unless the pin is ours
+  virtual void pushAdc(uint8_t pin, uint16_t raw) = 0;
+  virtual uint8_t phPin() const = 0;
+  virtual uint8_t ldrPin() const = 0;
+
+  // ControlCore's scheduler jobs and loop hooks
+  virtual uint32_t runVPD(uint32_t currentTime) = 0;
+  virtual uint32_t runPH(uint32_t currentTime) = 0;
+  virtual uint32_t runReservoir(uint32_t currentTime) = 0;
+  virtual uint32_t runRotation(uint32_t currentTime) = 0;
+  virtual void serviceRotation() = 0;
+  virtual void recordLoopPass(uint32_t micros) = 0;
+
+  const char* const name;
+  SensorSnapshot snapshot;  // Only written by sample()
+  ControlState& control;
+};
+
+template <class Board>
+class BoardZone : public Zone {
+public:
+  explicit BoardZone(const char* name)
+      : Zone(name, core),
+        stepper(AccelStepper::DRIVER, Board::stepPin, Board::dirPin),
+        core(snapshot, stepper),
+        sampler(snapshot) {}
+
+  void begin() override {
+    core.begin();
+    if (!sampler.begin()) {
+      Serial.printf("Warning: Couldn't find SHT31 sensor for zone %s. Will continue with default values.\n", name);
+    }
+
+    stepper.setMaxSpeed(1000);
+    stepper.setAcceleration(500);
+  }
+
+  bool sample(uint32_t currentTime, bool climateAllowed, bool& climateRead) override {
+    return sampler.sample(currentTime, climateAllowed, climateRead);
+  }
+
+  uint32_t msUntilDue(uint32_t currentTime) override {
+    return sampler.msUntilDue(currentTime);
+  }
+
+  void pushAdc(uint8_t pin, uint16_t raw) override {
+    sampler.pushAdc(pin, raw);
+  }
+
+  uint8_t phPin() const override {
+    return Board::phPin;
+  }
+
+  uint8_t ldrPin() const override {
+    return Board::ldrPin;
+  }
+
+  uint32_t runVPD(uint32_t currentTime) override {
+    return core.runVPD(currentTime);
+  }
+
+  uint32_t runPH(uint32_t currentTime) override {
+    return core.runPH(currentTime);
+  }
+
+  uint32_t runReservoir(uint32_t currentTime) override {
+    return core.runReservoir(currentTime);
+  }
+
+  uint32_t runRotation(uint32_t currentTime) override {
+    return core.runRotation(currentTime);
+  }
+
+  void serviceRotation() override {
+    core.serviceRotation();
+  }
+
+  void recordLoopPass(uint32_t micros) override {
+    core.recordLoopPass(micros);
+  }
+
+private:
+  AccelStepper stepper;
+  ControlCore<Board> core;
+  SensorSampler<Board> sampler;
+};
+
+#endif